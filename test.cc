@@ -4,6 +4,8 @@
 #include <assert.h>
 #include <ctime>
 #include <set>
+#include <algorithm>
+#include <iterator>
 
 #include <boost/random.hpp>
 #include <boost/random/uniform_01.hpp>
@@ -13,6 +15,37 @@
 #include "varintdecode.h"
 
 static const int loops = 5;
+static const size_t interval = 128;
+
+static size_t
+append_unsorted(uint8_t *end, uint32_t value)
+{
+  return vbyte_append_unsorted32(end, value);
+}
+
+static size_t
+append_unsorted(uint8_t *end, uint64_t value)
+{
+  return vbyte_append_unsorted64(end, value);
+}
+
+// compresses |plain| one integer at a time with the scalar encoder
+template<typename Traits>
+static std::vector<uint8_t>
+compress_reference(const std::vector<typename Traits::type> &plain)
+{
+  std::vector<uint8_t> z(plain.size() * 10);
+  size_t size = 0;
+  for (size_t i = 0; i < plain.size(); i++) {
+    // the first delta of a sorted sequence is the value itself
+    if (i == 0)
+      size += append_unsorted(&z[size], plain[i]);
+    else
+      size += Traits::append(&z[size], plain[i - 1], plain[i]);
+  }
+  z.resize(size);
+  return z;
+}
 
 template<typename Traits>
 static void
@@ -22,6 +55,41 @@ run_compression_test(std::vector<typename Traits::type> &plain,
   size_t len = Traits::compress(&plain[0], &z[0], plain.size());
   z.resize(len);
   assert(len == Traits::compressed_size(&plain[0], plain.size()));
+
+  // the vectorized encoder is byte-identical to the scalar one; the short
+  // prefixes cover every length of the scalar tail
+  std::vector<uint8_t> reference = compress_reference<Traits>(plain);
+  assert(z == reference);
+  std::vector<uint8_t> prefix(z.size() + 16);
+  for (size_t i = 0; i < std::min<size_t>(plain.size(), 48); i++) {
+    size_t size = Traits::compress(&plain[0], &prefix[0], i);
+    assert(size == vbyte_locate(&z[0], z.size(), i));
+    assert(std::equal(prefix.begin(), prefix.begin() + size, z.begin()));
+  }
+}
+
+template<typename Traits>
+static void
+run_compression_bounded_test(const std::vector<typename Traits::type> &plain,
+                const std::vector<uint8_t> &z)
+{
+  std::vector<uint8_t> out(z.size() + 1);
+
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    for (size_t capacity = 0; capacity <= z.size() + 1;
+                    capacity += 1 + z.size() / 10) {
+      // the integers which end within |capacity| bytes
+      size_t expected = vbyte_count(&z[0], std::min(capacity, z.size()));
+      size_t consumed;
+      size_t size = Traits::compress_bounded(&plain[0], plain.size(),
+                      &out[0], capacity, &consumed);
+      assert(consumed == expected);
+      assert(size == vbyte_locate(&z[0], z.size(), consumed));
+      assert(std::equal(out.begin(), out.begin() + size, z.begin()));
+    }
+  }
+  printf("    %s encode bounded -> %f\n", Traits::name, t.seconds() / loops);
 }
 
 template<typename Traits>
@@ -39,6 +107,22 @@ run_uncompression_test(const std::vector<typename Traits::type> &plain,
   printf("    %s decode -> %f\n", Traits::name, t.seconds() / loops);
 }
 
+template<typename Traits>
+static void
+run_uncompression_bytes_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z,
+                std::vector<typename Traits::type> &out)
+{
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    size_t length = Traits::uncompress_bytes(&z[0], z.size(), &out[0]);
+    assert(length == plain.size());
+    for (uint32_t j = 0; j < plain.size(); j++)
+      assert(plain[j] == out[j]);
+  }
+  printf("    %s decode bytes -> %f\n", Traits::name, t.seconds() / loops);
+}
+
 template<typename Traits>
 static void
 run_select_test(const std::vector<typename Traits::type> &plain,
@@ -54,6 +138,80 @@ run_select_test(const std::vector<typename Traits::type> &plain,
   printf("    %s select -> %f\n", Traits::name, t.seconds() / loops);
 }
 
+template<typename Traits>
+static void
+run_select_many_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z)
+{
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < plain.size(); i += 1 + plain.size() / 100)
+    indices.push_back(i);
+  indices.push_back(plain.size() - 1);
+  std::vector<typename Traits::type> out(indices.size());
+
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    Traits::select_many(&z[0], z.size(), &indices[0], indices.size(),
+                    &out[0]);
+    for (size_t i = 0; i < indices.size(); i++)
+      assert(plain[indices[i]] == out[i]);
+  }
+  printf("    %s select many -> %f\n", Traits::name, t.seconds() / loops);
+}
+
+template<typename Traits>
+static void
+run_uncompression_range_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z,
+                std::vector<typename Traits::type> &out)
+{
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    for (size_t i = 0; i < plain.size(); i += 1 + plain.size() / 100) {
+      size_t end = std::min(plain.size(), i + 1 + i / 3);
+      size_t offset = Traits::uncompress_range(&z[0], z.size(), i, end,
+                      &out[0]);
+      assert(offset == Traits::compressed_size(&plain[0], end));
+      for (size_t j = i; j < end; j++)
+        assert(plain[j] == out[j - i]);
+    }
+  }
+  printf("    %s decode range -> %f\n", Traits::name, t.seconds() / loops);
+}
+
+template<typename Traits>
+static void
+run_uncompression_reverse_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z,
+                std::vector<typename Traits::type> &out)
+{
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    size_t length = Traits::uncompress_reverse(&z[0], z.size(), &out[0]);
+    assert(length == plain.size());
+    for (size_t j = 0; j < plain.size(); j++)
+      assert(plain[plain.size() - j - 1] == out[j]);
+  }
+  printf("    %s decode reverse -> %f\n", Traits::name, t.seconds() / loops);
+}
+
+template<typename Traits>
+static void
+run_locate_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z)
+{
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    assert(vbyte_count(&z[0], z.size()) == plain.size());
+    for (uint32_t i = 0; i < plain.size(); i += 1 + plain.size() / 100) {
+      size_t offset = vbyte_locate(&z[0], z.size(), i);
+      assert(offset == Traits::compressed_size(&plain[0], i));
+    }
+    assert(vbyte_locate(&z[0], z.size(), plain.size()) == z.size());
+  }
+  printf("    %s locate -> %f\n", Traits::name, t.seconds() / loops);
+}
+
 template<typename Traits>
 static void
 run_search_test(const std::vector<typename Traits::type> &plain,
@@ -110,12 +268,20 @@ run_tests(size_t length)
 
   // compress the data
   run_compression_test<Traits>(plain, z);
+  run_compression_bounded_test<Traits>(plain, z);
 
   // uncompress the data
   run_uncompression_test<Traits>(plain, z, out);
+  run_uncompression_bytes_test<Traits>(plain, z, out);
+  run_uncompression_range_test<Traits>(plain, z, out);
+  run_uncompression_reverse_test<Traits>(plain, z, out);
 
   // select values
   run_select_test<Traits>(plain, z);
+  run_select_many_test<Traits>(plain, z);
+
+  // count and locate values
+  run_locate_test<Traits>(plain, z);
 
   // search for keys
   run_search_test<Traits>(plain, z);
@@ -124,8 +290,479 @@ run_tests(size_t length)
   run_append_test<Traits>(plain, z);
 }
 
+template<typename Traits>
+static void
+run_index_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z,
+                const std::vector<typename Traits::sample> &samples)
+{
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    for (uint32_t i = 0; i < plain.size(); i += 1 + plain.size() / 100) {
+      typename Traits::type v = Traits::select_indexed(&z[0], z.size(),
+                      &samples[0], interval, i);
+      assert(plain[i] == v);
+    }
+  }
+  printf("    %s indexed select -> %f\n", Traits::name, t.seconds() / loops);
+
+  t.start();
+  for (int l = 0; l < loops; l++) {
+    for (size_t i = 0; i < plain.size(); i += 1 + plain.size() / 5000) {
+      typename Traits::type found;
+      size_t pos = Traits::search_indexed(&z[0], plain.size(), &samples[0],
+                      interval, plain[i], &found);
+      assert(found == plain[i]);
+      assert(i == pos);
+    }
+  }
+  printf("    %s indexed search -> %f\n", Traits::name, t.seconds() / loops);
+}
+
+template<typename Traits>
+static void
+run_search_many_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z)
+{
+  std::vector<typename Traits::type> keys;
+  for (size_t i = 0; i < plain.size(); i += 1 + plain.size() / 5000)
+    keys.push_back(plain[i]);
+  keys.push_back(plain.back() + 1);
+  std::vector<size_t> positions(keys.size());
+  std::vector<typename Traits::type> found(keys.size());
+
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    Traits::search_many(&z[0], plain.size(), &keys[0], keys.size(),
+                    &positions[0], &found[0]);
+    for (size_t i = 0, j = 0; i < plain.size(); i += 1 + plain.size() / 5000) {
+      assert(positions[j] == i);
+      assert(found[j] == plain[i]);
+      j++;
+    }
+    assert(positions.back() == plain.size());
+  }
+  printf("    %s search many -> %f\n", Traits::name, t.seconds() / loops);
+}
+
+template<typename Traits>
+static void
+run_count_range_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z)
+{
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    for (size_t i = 0; i < plain.size(); i += 1 + plain.size() / 100) {
+      size_t j = i + (plain.size() - i) / 2;
+      assert(Traits::count_range(&z[0], plain.size(), plain[i],
+                              plain[j]) == j - i);
+      assert(Traits::count_range(&z[0], plain.size(), plain[i],
+                              plain.back() + 1) == plain.size() - i);
+    }
+  }
+  printf("    %s count range -> %f\n", Traits::name, t.seconds() / loops);
+}
+
+template<typename Traits>
+static void
+run_cursor_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z,
+                const std::vector<typename Traits::sample> &samples)
+{
+  typename Traits::cursor cursor;
+
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    Traits::cursor_init(&cursor, &z[0], plain.size(), 0, interval);
+    for (size_t i = 0; i < plain.size(); i++) {
+      assert(Traits::cursor_index(&cursor) == i);
+      assert(Traits::cursor_current(&cursor) == plain[i]);
+      assert(Traits::cursor_next(&cursor) == (i + 1 < plain.size()));
+    }
+    assert(Traits::cursor_index(&cursor) == plain.size());
+  }
+  printf("    %s cursor next -> %f\n", Traits::name, t.seconds() / loops);
+
+  // skip_to, without and with the skip index
+  t.start();
+  for (int l = 0; l < loops; l++) {
+    for (int indexed = 0; indexed < 2; indexed++) {
+      Traits::cursor_init(&cursor, &z[0], plain.size(),
+                      indexed ? &samples[0] : 0, interval);
+      for (size_t i = 0; i < plain.size(); i += 1 + plain.size() / 5000) {
+        assert(Traits::cursor_skip_to(&cursor, plain[i]) == 1);
+        assert(Traits::cursor_index(&cursor) == i);
+        assert(Traits::cursor_current(&cursor) == plain[i]);
+      }
+      assert(Traits::cursor_skip_to(&cursor, plain.back() + 1) == 0);
+      assert(Traits::cursor_index(&cursor) == plain.size());
+    }
+  }
+  printf("    %s cursor skip -> %f\n", Traits::name, t.seconds() / loops);
+}
+
+// every third value of |plain|, and a value in between
+template<typename Traits>
+static std::vector<typename Traits::type>
+make_other(const std::vector<typename Traits::type> &plain)
+{
+  std::vector<typename Traits::type> other;
+  for (size_t i = 0; i < plain.size(); i += 3) {
+    other.push_back(plain[i]);
+    if (i + 1 < plain.size() && plain[i] + 1 < plain[i + 1])
+      other.push_back(plain[i] + 1);
+  }
+  return other;
+}
+
+template<typename Traits>
+static std::vector<uint8_t>
+compress_sorted(const std::vector<typename Traits::type> &plain,
+                typename Traits::type previous)
+{
+  std::vector<uint8_t> z(plain.size() * 10);
+  z.resize(Traits::compress(&plain[0], &z[0], previous, plain.size()));
+  return z;
+}
+
+// |plain| and make_other(plain) without their first values, compressed
+// with different (non-zero) initial values
+template<typename Traits>
+struct Tails {
+  Tails(const std::vector<typename Traits::type> &plain,
+                  const std::vector<typename Traits::type> &other)
+    : tail1(plain.begin() + 2, plain.end()),
+      tail2(std::lower_bound(other.begin(), other.end(), plain[2]),
+                  other.end()),
+      previous1(tail1[0] - 1), previous2(tail2[0] / 2),
+      zt1(compress_sorted<Traits>(tail1, previous1)),
+      zt2(compress_sorted<Traits>(tail2, previous2)) {
+  }
+
+  std::vector<typename Traits::type> tail1, tail2;
+  typename Traits::type previous1, previous2;
+  std::vector<uint8_t> zt1, zt2;
+};
+
+template<typename Traits>
+static void
+run_intersect_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z)
+{
+  std::vector<typename Traits::type> other = make_other<Traits>(plain);
+  std::vector<uint8_t> z2 = compress_sorted<Traits>(other, 0);
+  std::vector<typename Traits::type> result(other.size());
+
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    size_t count = Traits::intersect(&z[0], plain.size(), 0, &z2[0],
+                    other.size(), 0, &result[0]);
+    assert(count == (plain.size() + 2) / 3);
+    for (size_t i = 0; i < count; i++)
+      assert(result[i] == plain[i * 3]);
+  }
+  printf("    %s intersect -> %f\n", Traits::name, t.seconds() / loops);
+
+  // both inputs with non-zero initial values
+  if (plain.size() > 3) {
+    Tails<Traits> tails(plain, other);
+    std::vector<typename Traits::type> expected;
+    std::set_intersection(tails.tail1.begin(), tails.tail1.end(),
+                    tails.tail2.begin(), tails.tail2.end(),
+                    std::back_inserter(expected));
+    size_t count = Traits::intersect(&tails.zt1[0], tails.tail1.size(),
+                    tails.previous1, &tails.zt2[0], tails.tail2.size(),
+                    tails.previous2, &result[0]);
+    assert(count == expected.size());
+    assert(std::equal(expected.begin(), expected.end(), result.begin()));
+  }
+}
+
+template<typename Traits>
+static void
+run_union_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z)
+{
+  std::vector<typename Traits::type> other = make_other<Traits>(plain);
+  std::vector<uint8_t> z2 = compress_sorted<Traits>(other, 0);
+
+  std::set<typename Traits::type> merged(plain.begin(), plain.end());
+  merged.insert(other.begin(), other.end());
+  const uint8_t *inputs[] = {&z[0], &z2[0]};
+  size_t lengths[] = {plain.size(), other.size()};
+  typename Traits::type previous[] = {0, 0};
+  std::vector<uint8_t> zu(z.size() + z2.size());
+
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    size_t count;
+    size_t size = Traits::merge(inputs, lengths, previous, 2, &zu[0],
+                    &count);
+    assert(count == merged.size());
+    std::vector<typename Traits::type> result(count);
+    assert(Traits::uncompress(&zu[0], &result[0], count) == size);
+    assert(std::equal(merged.begin(), merged.end(), result.begin()));
+  }
+  printf("    %s union -> %f\n", Traits::name, t.seconds() / loops);
+
+  // both inputs with non-zero initial values; every input with a non-zero
+  // initial value may need 4 (or 9) more bytes
+  if (plain.size() > 3) {
+    Tails<Traits> tails(plain, other);
+    std::set<typename Traits::type> expected(tails.tail1.begin(),
+                    tails.tail1.end());
+    expected.insert(tails.tail2.begin(), tails.tail2.end());
+    const uint8_t *inputs[] = {&tails.zt1[0], &tails.zt2[0]};
+    size_t lengths[] = {tails.tail1.size(), tails.tail2.size()};
+    typename Traits::type previous[] = {tails.previous1, tails.previous2};
+    size_t bound = tails.zt1.size() + tails.zt2.size()
+            + 2 * (sizeof(typename Traits::type) == 4 ? 4 : 9);
+    std::vector<uint8_t> zu(bound);
+    size_t count;
+    size_t size = Traits::merge(inputs, lengths, previous, 2, &zu[0],
+                    &count);
+    assert(size <= bound);
+    assert(count == expected.size());
+    std::vector<typename Traits::type> result(count);
+    assert(Traits::uncompress(&zu[0], &result[0], count) == size);
+    assert(std::equal(expected.begin(), expected.end(), result.begin()));
+  }
+
+  // the same sequence VBYTE_UNION_MAX_INPUTS times; one more input is
+  // rejected
+  std::vector<const uint8_t *> many(VBYTE_UNION_MAX_INPUTS + 1, &z[0]);
+  std::vector<size_t> many_lengths(many.size(), plain.size());
+  std::vector<typename Traits::type> many_previous(many.size(), 0);
+  zu.resize(z.size() * many.size());
+  size_t count;
+  size_t size = Traits::merge(&many[0], &many_lengths[0], &many_previous[0],
+                  VBYTE_UNION_MAX_INPUTS, &zu[0], &count);
+  assert(count == plain.size());
+  assert(size == z.size());
+  assert(std::equal(z.begin(), z.end(), zu.begin()));
+  size = Traits::merge(&many[0], &many_lengths[0], &many_previous[0],
+                  many.size(), &zu[0], &count);
+  assert(size == (size_t)-1);
+  assert(count == 0);
+}
+
+template<typename Traits>
+static void
+run_difference_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z)
+{
+  std::vector<typename Traits::type> other = make_other<Traits>(plain);
+  std::vector<uint8_t> z2 = compress_sorted<Traits>(other, 0);
+
+  // every value except every third one
+  std::vector<typename Traits::type> remaining;
+  for (size_t i = 0; i < plain.size(); i++)
+    if (i % 3 != 0)
+      remaining.push_back(plain[i]);
+  std::vector<typename Traits::type> result(plain.size());
+  std::vector<uint8_t> zd(z.size());
+
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    size_t count = Traits::difference(&z[0], plain.size(), 0, &z2[0],
+                    other.size(), 0, &result[0]);
+    assert(count == remaining.size());
+    assert(std::equal(remaining.begin(), remaining.end(), result.begin()));
+
+    size_t size = Traits::difference_compressed(&z[0], plain.size(), 0,
+                    &z2[0], other.size(), 0, &zd[0], 0, &count);
+    assert(count == remaining.size());
+    assert(Traits::uncompress(&zd[0], &result[0], count) == size);
+    assert(std::equal(remaining.begin(), remaining.end(), result.begin()));
+  }
+  printf("    %s difference -> %f\n", Traits::name, t.seconds() / loops);
+
+  // both inputs with non-zero initial values; the compressed result starts
+  // with an initial value less than |previous1| and may need 4 (or 9) more
+  // bytes
+  if (plain.size() > 3) {
+    Tails<Traits> tails(plain, other);
+    std::vector<typename Traits::type> expected;
+    std::set_difference(tails.tail1.begin(), tails.tail1.end(),
+                    tails.tail2.begin(), tails.tail2.end(),
+                    std::back_inserter(expected));
+    size_t count = Traits::difference(&tails.zt1[0], tails.tail1.size(),
+                    tails.previous1, &tails.zt2[0], tails.tail2.size(),
+                    tails.previous2, &result[0]);
+    assert(count == expected.size());
+    assert(std::equal(expected.begin(), expected.end(), result.begin()));
+
+    typename Traits::type previous = tails.previous1 / 2;
+    size_t bound = tails.zt1.size()
+            + (sizeof(typename Traits::type) == 4 ? 4 : 9);
+    std::vector<uint8_t> zd(bound);
+    size_t size = Traits::difference_compressed(&tails.zt1[0],
+                    tails.tail1.size(), tails.previous1, &tails.zt2[0],
+                    tails.tail2.size(), tails.previous2, &zd[0], previous,
+                    &count);
+    assert(size <= bound);
+    assert(count == expected.size());
+    assert(Traits::uncompress(&zd[0], &result[0], previous, count) == size);
+    assert(std::equal(expected.begin(), expected.end(), result.begin()));
+  }
+}
+
+template<typename Traits>
+static void
+run_insert_erase_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z)
+{
+  // erase about 100 values, then insert them again
+  const size_t step = 1 + plain.size() / 100;
+  std::vector<typename Traits::type> kept;
+  for (size_t i = 0; i < plain.size(); i++)
+    if (i % step != 0)
+      kept.push_back(plain[i]);
+  std::vector<uint8_t> zi(z.size() + 16);
+
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    std::copy(z.begin(), z.end(), zi.begin());
+    size_t size = z.size();
+    size_t length = plain.size();
+    for (size_t i = 0; i < plain.size(); i += step) {
+      // erasing a value which does not exist is a no-op
+      if (!std::binary_search(plain.begin(), plain.end(), plain[i] + 1))
+        assert(Traits::erase(&zi[0], length, size, plain[i] + 1) == size);
+      size = Traits::erase(&zi[0], length--, size, plain[i]);
+    }
+    assert(length == kept.size());
+    assert(size == Traits::compressed_size(kept.data(), length));
+    for (size_t i = 0; i < plain.size(); i += step)
+      size = Traits::insert(&zi[0], length++, size, plain[i]);
+    assert(size == z.size());
+    assert(std::equal(z.begin(), z.end(), zi.begin()));
+  }
+  printf("    %s erase/insert -> %f\n", Traits::name, t.seconds() / loops);
+
+  // inserting behind the last value appends it; the search then yields
+  // the last value
+  typename Traits::type found;
+  assert(Traits::search(&z[0], plain.size(), plain.back() + 1, &found)
+                  == plain.size());
+  assert(found == plain.back());
+  std::copy(z.begin(), z.end(), zi.begin());
+  size_t size = Traits::erase(&zi[0], plain.size(), z.size(), plain.back());
+  size = Traits::insert(&zi[0], plain.size() - 1, size, plain.back());
+  assert(size == z.size());
+  assert(std::equal(z.begin(), z.end(), zi.begin()));
+}
+
+template<typename Traits>
+static void
+run_append_many_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z)
+{
+  // rebuild the sequence from its first value and batches of increasing
+  // size
+  std::vector<uint8_t> zi(z.size() + 16);
+
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    size_t size = append_unsorted(&zi[0], plain[0]);
+    typename Traits::type last = plain[0];
+    for (size_t i = 1, batch = 1; i < plain.size(); i += batch, batch *= 2) {
+      typename Traits::type highest = last;
+      size_t n = std::min(batch, plain.size() - i);
+      size += Traits::append_many(&zi[size], highest, &plain[i], n, &last);
+      assert(last == plain[i + n - 1]);
+    }
+    assert(size == z.size());
+    assert(std::equal(z.begin(), z.end(), zi.begin()));
+  }
+  printf("    %s append many -> %f\n", Traits::name, t.seconds() / loops);
+}
+
+template<typename Traits>
+static void
+run_split_concat_test(const std::vector<typename Traits::type> &plain,
+                std::vector<uint8_t> &z,
+                const std::vector<typename Traits::sample> &samples)
+{
+  std::vector<uint8_t> left(z.size() + 16);
+  std::vector<uint8_t> right(z.size() + 16);
+
+  Timer<boost::chrono::high_resolution_clock> t;
+  for (int l = 0; l < loops; l++) {
+    size_t left_size, right_size;
+    size_t count = Traits::split(&z[0], z.size(), &left[0], &left_size,
+                    &right[0], &right_size);
+    assert(left_size >= z.size() / 2 && left_size < z.size() / 2 + 10);
+    assert(std::equal(left.begin(), left.begin() + left_size, z.begin()));
+    assert(count == vbyte_count(&z[0], left_size));
+    std::vector<typename Traits::type> out(plain.size());
+    assert(Traits::uncompress_bytes(&right[0], right_size, &out[0])
+                    == plain.size() - count);
+    assert(std::equal(out.begin(), out.end() - count, plain.begin() + count));
+
+    // concatenating both halves restores the sequence
+    typename Traits::type last = count > 0 ? plain[count - 1] : 0;
+    size_t size = Traits::concat(&left[0], left_size, last, &right[0],
+                    right_size, &left[0]);
+    assert(size == z.size());
+    assert(std::equal(z.begin(), z.end(), left.begin()));
+  }
+  printf("    %s split/concat -> %f\n", Traits::name, t.seconds() / loops);
+
+  // the skip index yields the same halves
+  size_t left_size, right_size;
+  size_t count = Traits::split(&z[0], z.size(), &left[0], &left_size,
+                  &right[0], &right_size);
+  std::vector<uint8_t> left2(z.size() + 16);
+  std::vector<uint8_t> right2(z.size() + 16);
+  size_t left_size2, right_size2;
+  assert(Traits::split_indexed(&z[0], z.size(), plain.size(), &samples[0],
+                          interval, &left2[0], &left_size2, &right2[0],
+                          &right_size2) == count);
+  assert(left_size2 == left_size && right_size2 == right_size);
+  assert(std::equal(left.begin(), left.begin() + left_size, left2.begin()));
+  assert(std::equal(right.begin(), right.begin() + right_size,
+                          right2.begin()));
+}
+
+// tests the functions which only exist for sorted sequences
+template<typename Traits>
+static void
+run_sorted_tests(size_t length)
+{
+  std::vector<typename Traits::type> plain;
+  std::vector<uint8_t> z(length * 10);
+  std::vector<typename Traits::sample> samples((length + interval - 1)
+                  / interval);
+
+  for (size_t i = 0; i < length; i++)
+    plain.push_back(Traits::make_plain_value(i));
+
+  run_compression_test<Traits>(plain, z);
+  size_t count = Traits::build_index(&z[0], length, interval, &samples[0]);
+  assert(count == samples.size());
+
+  // select, search, count and iterate
+  run_index_test<Traits>(plain, z, samples);
+  run_search_many_test<Traits>(plain, z);
+  run_count_range_test<Traits>(plain, z);
+  run_cursor_test<Traits>(plain, z, samples);
+
+  // set operations
+  run_intersect_test<Traits>(plain, z);
+  run_union_test<Traits>(plain, z);
+  run_difference_test<Traits>(plain, z);
+
+  // build and modify compressed sequences
+  run_insert_erase_test<Traits>(plain, z);
+  run_append_many_test<Traits>(plain, z);
+  run_split_concat_test<Traits>(plain, z, samples);
+}
+
 struct Sorted32Traits {
   typedef uint32_t type;
+  typedef vbyte_sample32 sample;
+  typedef vbyte_cursor32 cursor;
   static constexpr const char *name = "Sorted32";
 
   static type make_plain_value(size_t i) {
@@ -135,6 +772,17 @@ struct Sorted32Traits {
   static size_t compress(const type *in, uint8_t *out, size_t length) {
     return vbyte_compress_sorted32(in, out, 0, length);
   }
+
+  static size_t compress(const type *in, uint8_t *out, type previous,
+                  size_t length) {
+    return vbyte_compress_sorted32(in, out, previous, length);
+  }
+
+  static size_t compress_bounded(const type *in, size_t length, uint8_t *out,
+                  size_t capacity, size_t *consumed) {
+    return vbyte_compress_sorted32_bounded(in, length, out, capacity, 0,
+                    consumed);
+  }
   
   static size_t compressed_size(const type *in, size_t length) {
     return vbyte_compressed_size_sorted32(in, length, 0);
@@ -144,15 +792,167 @@ struct Sorted32Traits {
     return vbyte_uncompress_sorted32(in, out, 0, length);
   } 
 
+  static size_t uncompress(const uint8_t *in, type *out, type previous,
+                  size_t length) {
+    return vbyte_uncompress_sorted32(in, out, previous, length);
+  }
+
+  static size_t uncompress_bytes(const uint8_t *in, size_t size, type *out) {
+    return vbyte_uncompress_sorted32_bytes(in, size, out, 0);
+  }
+
   static type select(const uint8_t *in, size_t length, size_t index) {
     return vbyte_select_sorted32(in, length, 0, index);
   } 
 
+  static void select_many(const uint8_t *in, size_t length,
+                  const size_t *indices, size_t count, type *out) {
+    vbyte_select_many_sorted32(in, length, 0, indices, count, out);
+  }
+
+  static size_t uncompress_range(const uint8_t *in, size_t length,
+                  size_t begin, size_t end, type *out) {
+    return vbyte_uncompress_range_sorted32(in, length, 0, begin, end, out);
+  }
+
+  static size_t uncompress_reverse(const uint8_t *in, size_t size,
+                  type *out) {
+    vbyte_reverse_cursor32 c;
+    size_t count = vbyte_count(in, size);
+    size_t length = 0;
+    if (vbyte_reverse_cursor_init32(&c, in, size, 0)) {
+      do {
+        assert(vbyte_reverse_cursor_index32(&c) + length + 1 == count);
+        out[length++] = vbyte_reverse_cursor_current32(&c);
+      } while (vbyte_reverse_cursor_prev32(&c));
+      assert(out[0] == vbyte_select_last_sorted32(in, size, 0));
+
+      // the same from the known last value
+      size_t i = 0;
+      vbyte_reverse_cursor_init_last32(&c, in, size, count, out[0]);
+      do {
+        assert(vbyte_reverse_cursor_current32(&c) == out[i++]);
+      } while (vbyte_reverse_cursor_prev32(&c));
+      assert(i == length);
+    }
+    return length;
+  }
+
+  static size_t build_index(const uint8_t *in, size_t length, size_t interval,
+                  sample *samples) {
+    return vbyte_build_index_sorted32(in, length, 0, interval, samples);
+  }
+
+  static type select_indexed(const uint8_t *in, size_t size,
+                  const sample *samples, size_t interval, size_t index) {
+    return vbyte_select_sorted_indexed32(in, size, samples, interval, index);
+  }
+
+  static size_t search_indexed(const uint8_t *in, size_t length,
+                  const sample *samples, size_t interval, type value,
+                  type *result) {
+    return vbyte_search_lower_bound_sorted_indexed32(in, length, samples,
+                    interval, value, result);
+  }
+
   static size_t search(const uint8_t *in, size_t length, type value,
                   type *result) {
     return vbyte_search_lower_bound_sorted32(in, length, value, 0, result);
   }
 
+  static void search_many(const uint8_t *in, size_t length,
+                  const type *values, size_t count, size_t *positions,
+                  type *result) {
+    vbyte_search_lower_bound_many_sorted32(in, length, 0, values, count,
+                    positions, result);
+  }
+
+  static size_t count_range(const uint8_t *in, size_t length, type low,
+                  type high) {
+    return vbyte_count_range_sorted32(in, length, 0, low, high);
+  }
+
+  static void cursor_init(cursor *c, const uint8_t *in, size_t length,
+                  const sample *samples, size_t interval) {
+    vbyte_cursor_init32(c, in, length, 0, samples, interval);
+  }
+
+  static int cursor_next(cursor *c) {
+    return vbyte_cursor_next32(c);
+  }
+
+  static int cursor_skip_to(cursor *c, type value) {
+    return vbyte_cursor_skip_to32(c, value);
+  }
+
+  static type cursor_current(const cursor *c) {
+    return vbyte_cursor_current32(c);
+  }
+
+  static size_t cursor_index(const cursor *c) {
+    return vbyte_cursor_index32(c);
+  }
+
+  static size_t intersect(const uint8_t *in1, size_t length1,
+                  type previous1, const uint8_t *in2, size_t length2,
+                  type previous2, type *out) {
+    return vbyte_intersect_sorted32(in1, length1, previous1, in2, length2,
+                    previous2, out);
+  }
+
+  static size_t merge(const uint8_t *const *inputs, const size_t *lengths,
+                  const type *previous, size_t count, uint8_t *out,
+                  size_t *length) {
+    return vbyte_union_sorted32(inputs, lengths, previous, count, out,
+                    length);
+  }
+
+  static size_t difference(const uint8_t *in1, size_t length1,
+                  type previous1, const uint8_t *in2, size_t length2,
+                  type previous2, type *out) {
+    return vbyte_difference_sorted32(in1, length1, previous1, in2, length2,
+                    previous2, out);
+  }
+
+  static size_t difference_compressed(const uint8_t *in1, size_t length1,
+                  type previous1, const uint8_t *in2, size_t length2,
+                  type previous2, uint8_t *out, type previous,
+                  size_t *length) {
+    return vbyte_difference_compressed_sorted32(in1, length1, previous1, in2,
+                    length2, previous2, out, previous, length);
+  }
+
+  static size_t insert(uint8_t *in, size_t length, size_t size, type value) {
+    return vbyte_insert_sorted32(in, length, size, 0, value);
+  }
+
+  static size_t erase(uint8_t *in, size_t length, size_t size, type value) {
+    return vbyte_erase_sorted32(in, length, size, 0, value);
+  }
+
+  static size_t append_many(uint8_t *end, type highest, const type *in,
+                  size_t length, type *last) {
+    return vbyte_append_many_sorted32(end, highest, in, length, last);
+  }
+
+  static size_t split(const uint8_t *in, size_t size, uint8_t *left,
+                  size_t *left_size, uint8_t *right, size_t *right_size) {
+    return vbyte_split_sorted32(in, size, 0, left, left_size, right,
+                    right_size);
+  }
+
+  static size_t split_indexed(const uint8_t *in, size_t size, size_t length,
+                  const sample *samples, size_t interval, uint8_t *left,
+                  size_t *left_size, uint8_t *right, size_t *right_size) {
+    return vbyte_split_sorted_indexed32(in, size, length, samples, interval,
+                    left, left_size, right, right_size);
+  }
+
+  static size_t concat(const uint8_t *in1, size_t size1, type last,
+                  const uint8_t *in2, size_t size2, uint8_t *out) {
+    return vbyte_concat_sorted32(in1, size1, last, in2, size2, 0, out);
+  }
+
   static size_t append(uint8_t *end, type highest, type value) {
     return vbyte_append_sorted64(end, highest, value);
   }
@@ -160,6 +960,8 @@ struct Sorted32Traits {
 
 struct Sorted64Traits {
   typedef uint64_t type;
+  typedef vbyte_sample64 sample;
+  typedef vbyte_cursor64 cursor;
   static constexpr const char *name = "Sorted64";
 
   static type make_plain_value(size_t i) {
@@ -170,6 +972,17 @@ struct Sorted64Traits {
     return vbyte_compress_sorted64(in, out, 0, length);
   }
 
+  static size_t compress(const type *in, uint8_t *out, type previous,
+                  size_t length) {
+    return vbyte_compress_sorted64(in, out, previous, length);
+  }
+
+  static size_t compress_bounded(const type *in, size_t length, uint8_t *out,
+                  size_t capacity, size_t *consumed) {
+    return vbyte_compress_sorted64_bounded(in, length, out, capacity, 0,
+                    consumed);
+  }
+
   static size_t compressed_size(const type *in, size_t length) {
     return vbyte_compressed_size_sorted64(in, length, 0);
   }
@@ -178,15 +991,167 @@ struct Sorted64Traits {
     return vbyte_uncompress_sorted64(in, out, 0, length);
   } 
 
+  static size_t uncompress(const uint8_t *in, type *out, type previous,
+                  size_t length) {
+    return vbyte_uncompress_sorted64(in, out, previous, length);
+  }
+
+  static size_t uncompress_bytes(const uint8_t *in, size_t size, type *out) {
+    return vbyte_uncompress_sorted64_bytes(in, size, out, 0);
+  }
+
   static type select(const uint8_t *in, size_t length, size_t index) {
     return vbyte_select_sorted64(in, length, 0, index);
   } 
 
+  static void select_many(const uint8_t *in, size_t length,
+                  const size_t *indices, size_t count, type *out) {
+    vbyte_select_many_sorted64(in, length, 0, indices, count, out);
+  }
+
+  static size_t uncompress_range(const uint8_t *in, size_t length,
+                  size_t begin, size_t end, type *out) {
+    return vbyte_uncompress_range_sorted64(in, length, 0, begin, end, out);
+  }
+
+  static size_t uncompress_reverse(const uint8_t *in, size_t size,
+                  type *out) {
+    vbyte_reverse_cursor64 c;
+    size_t count = vbyte_count(in, size);
+    size_t length = 0;
+    if (vbyte_reverse_cursor_init64(&c, in, size, 0)) {
+      do {
+        assert(vbyte_reverse_cursor_index64(&c) + length + 1 == count);
+        out[length++] = vbyte_reverse_cursor_current64(&c);
+      } while (vbyte_reverse_cursor_prev64(&c));
+      assert(out[0] == vbyte_select_last_sorted64(in, size, 0));
+
+      // the same from the known last value
+      size_t i = 0;
+      vbyte_reverse_cursor_init_last64(&c, in, size, count, out[0]);
+      do {
+        assert(vbyte_reverse_cursor_current64(&c) == out[i++]);
+      } while (vbyte_reverse_cursor_prev64(&c));
+      assert(i == length);
+    }
+    return length;
+  }
+
+  static size_t build_index(const uint8_t *in, size_t length, size_t interval,
+                  sample *samples) {
+    return vbyte_build_index_sorted64(in, length, 0, interval, samples);
+  }
+
+  static type select_indexed(const uint8_t *in, size_t size,
+                  const sample *samples, size_t interval, size_t index) {
+    return vbyte_select_sorted_indexed64(in, size, samples, interval, index);
+  }
+
+  static size_t search_indexed(const uint8_t *in, size_t length,
+                  const sample *samples, size_t interval, type value,
+                  type *result) {
+    return vbyte_search_lower_bound_sorted_indexed64(in, length, samples,
+                    interval, value, result);
+  }
+
   static size_t search(const uint8_t *in, size_t length, type value,
                   type *result) {
     return vbyte_search_lower_bound_sorted64(in, length, value, 0, result);
   }
 
+  static void search_many(const uint8_t *in, size_t length,
+                  const type *values, size_t count, size_t *positions,
+                  type *result) {
+    vbyte_search_lower_bound_many_sorted64(in, length, 0, values, count,
+                    positions, result);
+  }
+
+  static size_t count_range(const uint8_t *in, size_t length, type low,
+                  type high) {
+    return vbyte_count_range_sorted64(in, length, 0, low, high);
+  }
+
+  static void cursor_init(cursor *c, const uint8_t *in, size_t length,
+                  const sample *samples, size_t interval) {
+    vbyte_cursor_init64(c, in, length, 0, samples, interval);
+  }
+
+  static int cursor_next(cursor *c) {
+    return vbyte_cursor_next64(c);
+  }
+
+  static int cursor_skip_to(cursor *c, type value) {
+    return vbyte_cursor_skip_to64(c, value);
+  }
+
+  static type cursor_current(const cursor *c) {
+    return vbyte_cursor_current64(c);
+  }
+
+  static size_t cursor_index(const cursor *c) {
+    return vbyte_cursor_index64(c);
+  }
+
+  static size_t intersect(const uint8_t *in1, size_t length1,
+                  type previous1, const uint8_t *in2, size_t length2,
+                  type previous2, type *out) {
+    return vbyte_intersect_sorted64(in1, length1, previous1, in2, length2,
+                    previous2, out);
+  }
+
+  static size_t merge(const uint8_t *const *inputs, const size_t *lengths,
+                  const type *previous, size_t count, uint8_t *out,
+                  size_t *length) {
+    return vbyte_union_sorted64(inputs, lengths, previous, count, out,
+                    length);
+  }
+
+  static size_t difference(const uint8_t *in1, size_t length1,
+                  type previous1, const uint8_t *in2, size_t length2,
+                  type previous2, type *out) {
+    return vbyte_difference_sorted64(in1, length1, previous1, in2, length2,
+                    previous2, out);
+  }
+
+  static size_t difference_compressed(const uint8_t *in1, size_t length1,
+                  type previous1, const uint8_t *in2, size_t length2,
+                  type previous2, uint8_t *out, type previous,
+                  size_t *length) {
+    return vbyte_difference_compressed_sorted64(in1, length1, previous1, in2,
+                    length2, previous2, out, previous, length);
+  }
+
+  static size_t insert(uint8_t *in, size_t length, size_t size, type value) {
+    return vbyte_insert_sorted64(in, length, size, 0, value);
+  }
+
+  static size_t erase(uint8_t *in, size_t length, size_t size, type value) {
+    return vbyte_erase_sorted64(in, length, size, 0, value);
+  }
+
+  static size_t append_many(uint8_t *end, type highest, const type *in,
+                  size_t length, type *last) {
+    return vbyte_append_many_sorted64(end, highest, in, length, last);
+  }
+
+  static size_t split(const uint8_t *in, size_t size, uint8_t *left,
+                  size_t *left_size, uint8_t *right, size_t *right_size) {
+    return vbyte_split_sorted64(in, size, 0, left, left_size, right,
+                    right_size);
+  }
+
+  static size_t split_indexed(const uint8_t *in, size_t size, size_t length,
+                  const sample *samples, size_t interval, uint8_t *left,
+                  size_t *left_size, uint8_t *right, size_t *right_size) {
+    return vbyte_split_sorted_indexed64(in, size, length, samples, interval,
+                    left, left_size, right, right_size);
+  }
+
+  static size_t concat(const uint8_t *in1, size_t size1, type last,
+                  const uint8_t *in2, size_t size2, uint8_t *out) {
+    return vbyte_concat_sorted64(in1, size1, last, in2, size2, 0, out);
+  }
+
   static size_t append(uint8_t *end, type highest, type value) {
     return vbyte_append_sorted64(end, highest, value);
   }
@@ -204,6 +1169,12 @@ struct Unsorted32Traits {
     return vbyte_compress_unsorted32(in, out, length);
   }
 
+  static size_t compress_bounded(const type *in, size_t length, uint8_t *out,
+                  size_t capacity, size_t *consumed) {
+    return vbyte_compress_unsorted32_bounded(in, length, out, capacity,
+                    consumed);
+  }
+
   static size_t compressed_size(const type *in, size_t length) {
     return vbyte_compressed_size_unsorted32(in, length);
   }
@@ -212,10 +1183,35 @@ struct Unsorted32Traits {
     return vbyte_uncompress_unsorted32(in, out, length);
   } 
 
+  static size_t uncompress_bytes(const uint8_t *in, size_t size, type *out) {
+    return vbyte_uncompress_unsorted32_bytes(in, size, out);
+  }
+
   static type select(const uint8_t *in, size_t length, size_t index) {
     return vbyte_select_unsorted32(in, length, index);
   } 
 
+  static void select_many(const uint8_t *in, size_t length,
+                  const size_t *indices, size_t count, type *out) {
+    vbyte_select_many_unsorted32(in, length, indices, count, out);
+  }
+
+  static size_t uncompress_range(const uint8_t *in, size_t length,
+                  size_t begin, size_t end, type *out) {
+    return vbyte_uncompress_range_unsorted32(in, length, begin, end, out);
+  }
+
+  static size_t uncompress_reverse(const uint8_t *in, size_t size,
+                  type *out) {
+    size_t length = vbyte_count(in, size);
+    // decode in two steps to continue from the returned offset
+    size = vbyte_uncompress_reverse_unsorted32(in, size, out, length / 2);
+    size = vbyte_uncompress_reverse_unsorted32(in, size, out + length / 2,
+                    length - length / 2);
+    assert(size == 0);
+    return length;
+  }
+
   static size_t search(const uint8_t *in, size_t length, type value,
                   type *result) {
     *result = value;
@@ -239,6 +1235,12 @@ struct Unsorted64Traits {
     return vbyte_compress_unsorted64(in, out, length);
   }
 
+  static size_t compress_bounded(const type *in, size_t length, uint8_t *out,
+                  size_t capacity, size_t *consumed) {
+    return vbyte_compress_unsorted64_bounded(in, length, out, capacity,
+                    consumed);
+  }
+
   static size_t compressed_size(const type *in, size_t length) {
     return vbyte_compressed_size_unsorted64(in, length);
   }
@@ -247,10 +1249,35 @@ struct Unsorted64Traits {
     return vbyte_uncompress_unsorted64(in, out, length);
   } 
 
+  static size_t uncompress_bytes(const uint8_t *in, size_t size, type *out) {
+    return vbyte_uncompress_unsorted64_bytes(in, size, out);
+  }
+
   static type select(const uint8_t *in, size_t length, size_t index) {
     return vbyte_select_unsorted64(in, length, index);
   } 
 
+  static void select_many(const uint8_t *in, size_t length,
+                  const size_t *indices, size_t count, type *out) {
+    vbyte_select_many_unsorted64(in, length, indices, count, out);
+  }
+
+  static size_t uncompress_range(const uint8_t *in, size_t length,
+                  size_t begin, size_t end, type *out) {
+    return vbyte_uncompress_range_unsorted64(in, length, begin, end, out);
+  }
+
+  static size_t uncompress_reverse(const uint8_t *in, size_t size,
+                  type *out) {
+    size_t length = vbyte_count(in, size);
+    // decode in two steps to continue from the returned offset
+    size = vbyte_uncompress_reverse_unsorted64(in, size, out, length / 2);
+    size = vbyte_uncompress_reverse_unsorted64(in, size, out + length / 2,
+                    length - length / 2);
+    assert(size == 0);
+    return length;
+  }
+
   static size_t search(const uint8_t *in, size_t length, type value,
                   type *result) {
     *result = value;
@@ -262,20 +1289,46 @@ struct Unsorted64Traits {
   }
 };
 
+// 64bit values which require 6 to 10 bytes
+struct Sorted64LargeTraits : public Sorted64Traits {
+  static constexpr const char *name = "Sorted64Large";
+
+  static type make_plain_value(size_t i) {
+    return (type)i << 40;
+  }
+};
+
+struct Unsorted64LargeTraits : public Unsorted64Traits {
+  static constexpr const char *name = "Unsorted64Large";
+
+  static type make_plain_value(size_t i) {
+    return (type)i | (1ull << (32 + i % 32));
+  }
+};
+
 inline static void
 test(size_t length)
 {
   printf("%u, sorted, 32bit\n", (uint32_t)length);
   run_tests<Sorted32Traits>(length);
+  run_sorted_tests<Sorted32Traits>(length);
 
   printf("%u, sorted, 64bit\n", (uint32_t)length);
   run_tests<Sorted64Traits>(length);
+  run_sorted_tests<Sorted64Traits>(length);
 
   printf("%u, unsorted, 32bit\n", (uint32_t)length);
   run_tests<Unsorted32Traits>(length);
 
   printf("%u, unsorted, 64bit\n", (uint32_t)length);
   run_tests<Unsorted64Traits>(length);
+
+  printf("%u, sorted, 64bit (large)\n", (uint32_t)length);
+  run_tests<Sorted64LargeTraits>(length);
+  run_sorted_tests<Sorted64LargeTraits>(length);
+
+  printf("%u, unsorted, 64bit (large)\n", (uint32_t)length);
+  run_tests<Unsorted64LargeTraits>(length);
 }
 
 int
@@ -2,6 +2,16 @@
 
 #include <x86intrin.h>
 
+// The build compiles this file once per instruction set, i.e. with
+// "-msse4.1 -DMASKEDVBYTE_ISA=sse41", "-mavx -DMASKEDVBYTE_ISA=avx" and
+// "-mavx2 -DMASKEDVBYTE_ISA=avx2"
+#ifndef MASKEDVBYTE_ISA
+#  define MASKEDVBYTE_ISA avx
+#endif
+
+#define MASKEDVBYTE_CONCAT_(a, b) a ## _ ## b
+#define MASKEDVBYTE_CONCAT(a, b) MASKEDVBYTE_CONCAT_(a, b)
+
 #if defined(_MSC_VER)
 #define ALIGNED(x) __declspec(align(x))
 #else
@@ -13,7 +23,6 @@
 
 #if defined(_MSC_VER)
 # include <intrin.h>
-/* 64-bit needs extending */
 # define SIMDCOMP_CTZ(result, mask) do { \
         unsigned long index; \
         if (!_BitScanForward(&(index), (mask))) { \
@@ -22,9 +31,33 @@
             (result) = (uint32_t)(index); \
         } \
     } while (0)
+# define SIMDCOMP_CTZ64(result, mask) do { \
+        unsigned long index; \
+        if (!_BitScanForward64(&(index), (mask))) { \
+            (result) = 64U; \
+        } else { \
+            (result) = (uint32_t)(index); \
+        } \
+    } while (0)
+# define SIMDCOMP_CLZ64(result, mask) do { \
+        unsigned long index; \
+        if (!_BitScanReverse64(&(index), (mask))) { \
+            (result) = 64U; \
+        } else { \
+            (result) = 63U - (uint32_t)(index); \
+        } \
+    } while (0)
+# define SIMDCOMP_POPCOUNT64(result, mask) \
+    result = (uint32_t)__popcnt64(mask)
 #else
 # define SIMDCOMP_CTZ(result, mask) \
     result = __builtin_ctz(mask)
+# define SIMDCOMP_CTZ64(result, mask) \
+    result = __builtin_ctzll(mask)
+# define SIMDCOMP_CLZ64(result, mask) \
+    result = __builtin_clzll(mask)
+# define SIMDCOMP_POPCOUNT64(result, mask) \
+    result = __builtin_popcountll(mask)
 #endif
 
 typedef struct index_bytes_consumed {
@@ -1044,57 +1077,176 @@ static uint64_t masked_vbyte_read_group_delta(const uint8_t* in, uint32_t* out,
 }
 
 
-static int read_int_group(const uint8_t* in, uint32_t* out, int* ints_read) {
+// shuffles two 64-bit values of 1 to 8 bytes each into the two 64-bit lanes,
+// indexed by ((length of first value - 1) * 8 + (length of second value - 1))
+static const int8_t vectors64rawbytes[] ALIGNED(0x1000) = {
+	 0, -1, -1, -1, -1, -1, -1, -1,  1, -1, -1, -1, -1, -1, -1, -1,  // 1, 1
+	 0, -1, -1, -1, -1, -1, -1, -1,  1,  2, -1, -1, -1, -1, -1, -1,  // 1, 2
+	 0, -1, -1, -1, -1, -1, -1, -1,  1,  2,  3, -1, -1, -1, -1, -1,  // 1, 3
+	 0, -1, -1, -1, -1, -1, -1, -1,  1,  2,  3,  4, -1, -1, -1, -1,  // 1, 4
+	 0, -1, -1, -1, -1, -1, -1, -1,  1,  2,  3,  4,  5, -1, -1, -1,  // 1, 5
+	 0, -1, -1, -1, -1, -1, -1, -1,  1,  2,  3,  4,  5,  6, -1, -1,  // 1, 6
+	 0, -1, -1, -1, -1, -1, -1, -1,  1,  2,  3,  4,  5,  6,  7, -1,  // 1, 7
+	 0, -1, -1, -1, -1, -1, -1, -1,  1,  2,  3,  4,  5,  6,  7,  8,  // 1, 8
+	 0,  1, -1, -1, -1, -1, -1, -1,  2, -1, -1, -1, -1, -1, -1, -1,  // 2, 1
+	 0,  1, -1, -1, -1, -1, -1, -1,  2,  3, -1, -1, -1, -1, -1, -1,  // 2, 2
+	 0,  1, -1, -1, -1, -1, -1, -1,  2,  3,  4, -1, -1, -1, -1, -1,  // 2, 3
+	 0,  1, -1, -1, -1, -1, -1, -1,  2,  3,  4,  5, -1, -1, -1, -1,  // 2, 4
+	 0,  1, -1, -1, -1, -1, -1, -1,  2,  3,  4,  5,  6, -1, -1, -1,  // 2, 5
+	 0,  1, -1, -1, -1, -1, -1, -1,  2,  3,  4,  5,  6,  7, -1, -1,  // 2, 6
+	 0,  1, -1, -1, -1, -1, -1, -1,  2,  3,  4,  5,  6,  7,  8, -1,  // 2, 7
+	 0,  1, -1, -1, -1, -1, -1, -1,  2,  3,  4,  5,  6,  7,  8,  9,  // 2, 8
+	 0,  1,  2, -1, -1, -1, -1, -1,  3, -1, -1, -1, -1, -1, -1, -1,  // 3, 1
+	 0,  1,  2, -1, -1, -1, -1, -1,  3,  4, -1, -1, -1, -1, -1, -1,  // 3, 2
+	 0,  1,  2, -1, -1, -1, -1, -1,  3,  4,  5, -1, -1, -1, -1, -1,  // 3, 3
+	 0,  1,  2, -1, -1, -1, -1, -1,  3,  4,  5,  6, -1, -1, -1, -1,  // 3, 4
+	 0,  1,  2, -1, -1, -1, -1, -1,  3,  4,  5,  6,  7, -1, -1, -1,  // 3, 5
+	 0,  1,  2, -1, -1, -1, -1, -1,  3,  4,  5,  6,  7,  8, -1, -1,  // 3, 6
+	 0,  1,  2, -1, -1, -1, -1, -1,  3,  4,  5,  6,  7,  8,  9, -1,  // 3, 7
+	 0,  1,  2, -1, -1, -1, -1, -1,  3,  4,  5,  6,  7,  8,  9, 10,  // 3, 8
+	 0,  1,  2,  3, -1, -1, -1, -1,  4, -1, -1, -1, -1, -1, -1, -1,  // 4, 1
+	 0,  1,  2,  3, -1, -1, -1, -1,  4,  5, -1, -1, -1, -1, -1, -1,  // 4, 2
+	 0,  1,  2,  3, -1, -1, -1, -1,  4,  5,  6, -1, -1, -1, -1, -1,  // 4, 3
+	 0,  1,  2,  3, -1, -1, -1, -1,  4,  5,  6,  7, -1, -1, -1, -1,  // 4, 4
+	 0,  1,  2,  3, -1, -1, -1, -1,  4,  5,  6,  7,  8, -1, -1, -1,  // 4, 5
+	 0,  1,  2,  3, -1, -1, -1, -1,  4,  5,  6,  7,  8,  9, -1, -1,  // 4, 6
+	 0,  1,  2,  3, -1, -1, -1, -1,  4,  5,  6,  7,  8,  9, 10, -1,  // 4, 7
+	 0,  1,  2,  3, -1, -1, -1, -1,  4,  5,  6,  7,  8,  9, 10, 11,  // 4, 8
+	 0,  1,  2,  3,  4, -1, -1, -1,  5, -1, -1, -1, -1, -1, -1, -1,  // 5, 1
+	 0,  1,  2,  3,  4, -1, -1, -1,  5,  6, -1, -1, -1, -1, -1, -1,  // 5, 2
+	 0,  1,  2,  3,  4, -1, -1, -1,  5,  6,  7, -1, -1, -1, -1, -1,  // 5, 3
+	 0,  1,  2,  3,  4, -1, -1, -1,  5,  6,  7,  8, -1, -1, -1, -1,  // 5, 4
+	 0,  1,  2,  3,  4, -1, -1, -1,  5,  6,  7,  8,  9, -1, -1, -1,  // 5, 5
+	 0,  1,  2,  3,  4, -1, -1, -1,  5,  6,  7,  8,  9, 10, -1, -1,  // 5, 6
+	 0,  1,  2,  3,  4, -1, -1, -1,  5,  6,  7,  8,  9, 10, 11, -1,  // 5, 7
+	 0,  1,  2,  3,  4, -1, -1, -1,  5,  6,  7,  8,  9, 10, 11, 12,  // 5, 8
+	 0,  1,  2,  3,  4,  5, -1, -1,  6, -1, -1, -1, -1, -1, -1, -1,  // 6, 1
+	 0,  1,  2,  3,  4,  5, -1, -1,  6,  7, -1, -1, -1, -1, -1, -1,  // 6, 2
+	 0,  1,  2,  3,  4,  5, -1, -1,  6,  7,  8, -1, -1, -1, -1, -1,  // 6, 3
+	 0,  1,  2,  3,  4,  5, -1, -1,  6,  7,  8,  9, -1, -1, -1, -1,  // 6, 4
+	 0,  1,  2,  3,  4,  5, -1, -1,  6,  7,  8,  9, 10, -1, -1, -1,  // 6, 5
+	 0,  1,  2,  3,  4,  5, -1, -1,  6,  7,  8,  9, 10, 11, -1, -1,  // 6, 6
+	 0,  1,  2,  3,  4,  5, -1, -1,  6,  7,  8,  9, 10, 11, 12, -1,  // 6, 7
+	 0,  1,  2,  3,  4,  5, -1, -1,  6,  7,  8,  9, 10, 11, 12, 13,  // 6, 8
+	 0,  1,  2,  3,  4,  5,  6, -1,  7, -1, -1, -1, -1, -1, -1, -1,  // 7, 1
+	 0,  1,  2,  3,  4,  5,  6, -1,  7,  8, -1, -1, -1, -1, -1, -1,  // 7, 2
+	 0,  1,  2,  3,  4,  5,  6, -1,  7,  8,  9, -1, -1, -1, -1, -1,  // 7, 3
+	 0,  1,  2,  3,  4,  5,  6, -1,  7,  8,  9, 10, -1, -1, -1, -1,  // 7, 4
+	 0,  1,  2,  3,  4,  5,  6, -1,  7,  8,  9, 10, 11, -1, -1, -1,  // 7, 5
+	 0,  1,  2,  3,  4,  5,  6, -1,  7,  8,  9, 10, 11, 12, -1, -1,  // 7, 6
+	 0,  1,  2,  3,  4,  5,  6, -1,  7,  8,  9, 10, 11, 12, 13, -1,  // 7, 7
+	 0,  1,  2,  3,  4,  5,  6, -1,  7,  8,  9, 10, 11, 12, 13, 14,  // 7, 8
+	 0,  1,  2,  3,  4,  5,  6,  7,  8, -1, -1, -1, -1, -1, -1, -1,  // 8, 1
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,  // 8, 2
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, -1, -1, -1, -1, -1,  // 8, 3
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, -1, -1, -1, -1,  // 8, 4
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, -1, -1, -1,  // 8, 5
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, -1, -1,  // 8, 6
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, -1,  // 8, 7
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,  // 8, 8
+};
 
-	__m128i initial = _mm_lddqu_si128((const __m128i *) in);
-	__m128i * const mout = (__m128i *) out;
+static const __m128i* vectors64 = (const __m128i*)vectors64rawbytes;
 
-	int mask = _mm_movemask_epi8(initial);
-	if (mask == 0) {
-		__m128i result;
-		result = _mm_cvtepi8_epi32(initial);
-		initial = _mm_srli_si128(initial, 4);
-		_mm_storeu_si128(mout, result);
-		result = _mm_cvtepi8_epi32(initial);
-		initial = _mm_srli_si128(initial, 4);
-		_mm_storeu_si128(mout + 1, result);
-		result = _mm_cvtepi8_epi32(initial);
-		initial = _mm_srli_si128(initial, 4);
-		_mm_storeu_si128(mout + 2, result);
-		result = _mm_cvtepi8_epi32(initial);
-		_mm_storeu_si128(mout + 3, result);
-		*ints_read = 16;
-		return 16;
+static int read_int64(const uint8_t* in, uint64_t* out) {
+	*out = in[0] & 0x7F;
+	if (in[0] < 128) {
+		return 1;
+	}
+	int i;
+	for (i = 1; i < 10; i++) {
+		*out |= (uint64_t)(in[i] & 0x7FU) << (7 * i);
+		if (in[i] < 128) {
+			return i + 1;
+		}
 	}
-	int mask2 = mask & 0xFFF;
-	index_bytes_consumed combined = combined_lookup[mask2];
+	return 10;
+}
 
-	int index = combined.index;
+static inline __m128i PrefixSum64(__m128i curr, __m128i prev) {
+	__m128i Add = _mm_slli_si128(curr, 8);  // [- A]
+	prev = _mm_unpackhi_epi64(prev, prev);  // [P P]
+	curr = _mm_add_epi64(curr, Add);        // [A AB]
+	return _mm_add_epi64(curr, prev);       // [PA PAB]
+}
 
-	__m128i shuffle_vector = vectors[index];
-	int consumed = combined.bytes_consumed;
+// stores two 64-bit integers; if |prev| is not NULL then the integers are
+// deltas and |*prev| is updated with their prefix sum
+static inline void store64(__m128i* mout, __m128i result, __m128i* prev) {
+	if (prev) {
+		*prev = PrefixSum64(result, *prev);
+		result = *prev;
+	}
+	_mm_storeu_si128(mout, result);
+}
 
-	if (index < 64) {
-		*ints_read = 6;
-		__m128i bytes_to_decode = _mm_shuffle_epi8(initial, shuffle_vector);
-		__m128i low_bytes = _mm_and_si128(bytes_to_decode,
-				_mm_set1_epi16(0x007F));
-		__m128i high_bytes = _mm_and_si128(bytes_to_decode,
-				_mm_set1_epi16(0x7F00));
-		__m128i high_bytes_shifted = _mm_srli_epi16(high_bytes, 1);
-		__m128i packed_result = _mm_or_si128(low_bytes, high_bytes_shifted);
-		__m128i unpacked_result_a = _mm_and_si128(packed_result,
-				_mm_set1_epi32(0x0000FFFF));
-		_mm_storeu_si128(mout, unpacked_result_a);
-		__m128i unpacked_result_b = _mm_srli_epi32(packed_result, 16);
-		_mm_storel_epi64(mout + 1, unpacked_result_b);
-		return consumed;
+// same as store64, but only the lower 64-bit integer is stored
+static inline void store64_1int(__m128i* mout, __m128i result, __m128i* prev) {
+	if (prev) {
+		*prev = PrefixSum64(_mm_move_epi64(result), *prev);
+		result = *prev;
 	}
-	if (index < 145) {
+	_mm_storel_epi64(mout, result);
+}
 
-		*ints_read = 4;
+// squeezes the 7-bit groups in each 64-bit lane into a 56-bit integer
+static inline __m128i compact64(__m128i bytes_to_decode) {
+	__m128i low = _mm_and_si128(bytes_to_decode, _mm_set1_epi16(0x007F));
+	__m128i high = _mm_and_si128(bytes_to_decode, _mm_set1_epi16(0x7F00));
+	__m128i result = _mm_or_si128(low, _mm_srli_epi16(high, 1));
+	low = _mm_and_si128(result, _mm_set1_epi32(0x00003FFF));
+	high = _mm_and_si128(result, _mm_set1_epi32(0x3FFF0000));
+	result = _mm_or_si128(low, _mm_srli_epi32(high, 2));
+	low = _mm_and_si128(result, _mm_set1_epi64x(0x000000000FFFFFFFLL));
+	high = _mm_and_si128(result, _mm_set1_epi64x(0x0FFFFFFF00000000LL));
+	return _mm_or_si128(low, _mm_srli_epi64(high, 4));
+}
+
+static inline uint64_t masked_vbyte_read_group64(const uint8_t* in,
+		uint64_t* out, uint64_t mask, uint64_t* ints_read, __m128i* prev) {
+	__m128i initial = _mm_lddqu_si128((const __m128i *) (in));
+	__m128i * mout = (__m128i *) out;
+
+	if (!(mask & 0xFFFF)) {
+		int i;
+		for (i = 0; i < 8; i++) {
+			store64(mout + i, _mm_cvtepu8_epi64(initial), prev);
+			initial = _mm_srli_si128(initial, 2);
+		}
+		*ints_read = 16;
+		return 16;
+	}
 
+	// values with at most 3 bytes are decoded with the 32-bit kernel, then
+	// widened to 64-bit
+	uint32_t low_12_bits = mask & 0xFFF;
+	if ((low_12_bits & (low_12_bits >> 1) & (low_12_bits >> 2)) == 0) {
+		index_bytes_consumed combined = combined_lookup[low_12_bits];
+		uint64_t consumed = combined.bytes_consumed;
+		uint8_t index = combined.index;
+
+		__m128i shuffle_vector = vectors[index];
 		__m128i bytes_to_decode = _mm_shuffle_epi8(initial, shuffle_vector);
+
+		if (index < 64) {
+			*ints_read = 6;
+			__m128i low_bytes = _mm_and_si128(bytes_to_decode,
+					_mm_set1_epi16(0x007F));
+			__m128i high_bytes = _mm_and_si128(bytes_to_decode,
+					_mm_set1_epi16(0x7F00));
+			__m128i high_bytes_shifted = _mm_srli_epi16(high_bytes, 1);
+			__m128i packed_result = _mm_or_si128(low_bytes, high_bytes_shifted);
+			__m128i unpacked_result_a = _mm_and_si128(packed_result,
+					_mm_set1_epi32(0x0000FFFF));
+			__m128i unpacked_result_b = _mm_srli_epi32(packed_result, 16);
+			store64(mout, _mm_cvtepu32_epi64(unpacked_result_a), prev);
+			store64(mout + 1, _mm_cvtepu32_epi64(
+						_mm_srli_si128(unpacked_result_a, 8)), prev);
+			store64(mout + 2, _mm_cvtepu32_epi64(unpacked_result_b), prev);
+			return consumed;
+		}
+
+		*ints_read = 4;
 		__m128i low_bytes = _mm_and_si128(bytes_to_decode,
 				_mm_set1_epi32(0x0000007F));
 		__m128i middle_bytes = _mm_and_si128(bytes_to_decode,
@@ -1105,31 +1257,42 @@ static int read_int_group(const uint8_t* in, uint32_t* out, int* ints_read) {
 		__m128i high_bytes_shifted = _mm_srli_epi32(high_bytes, 2);
 		__m128i low_middle = _mm_or_si128(low_bytes, middle_bytes_shifted);
 		__m128i result = _mm_or_si128(low_middle, high_bytes_shifted);
-		_mm_storeu_si128(mout, result);
+		store64(mout, _mm_cvtepu32_epi64(result), prev);
+		store64(mout + 1, _mm_cvtepu32_epi64(_mm_srli_si128(result, 8)), prev);
 		return consumed;
 	}
 
+	// longer values are decoded two at a time, one per 64-bit lane
+	uint32_t len1, len2;
+	SIMDCOMP_CTZ(len1, ~(uint32_t)mask);
+	len1 += 1;
+	if (len1 > 8) {
+		// 9 or 10 bytes: the result does not fit into 56 bits
+		uint64_t value;
+		uint64_t consumed = read_int64(in, &value);
+		store64_1int(mout, _mm_set1_epi64x((long long)value), prev);
+		*ints_read = 1;
+		return consumed;
+	}
+	SIMDCOMP_CTZ(len2, ~(uint32_t)(mask >> len1));
+	len2 += 1;
+	if (len2 > 8 || len1 + len2 > 16) {
+		__m128i result = compact64(_mm_shuffle_epi8(initial,
+					vectors64[(len1 - 1) * 8]));
+		store64_1int(mout, result, prev);
+		*ints_read = 1;
+		return len1;
+	}
+	__m128i result = compact64(_mm_shuffle_epi8(initial,
+				vectors64[(len1 - 1) * 8 + len2 - 1]));
+	store64(mout, result, prev);
 	*ints_read = 2;
-
-	__m128i data_bits = _mm_and_si128(initial, _mm_set1_epi8(0x7F));
-	__m128i bytes_to_decode = _mm_shuffle_epi8(data_bits, shuffle_vector);
-	__m128i split_bytes = _mm_mullo_epi16(bytes_to_decode,
-			_mm_setr_epi16(128, 64, 32, 16, 128, 64, 32, 16));
-	__m128i shifted_split_bytes = _mm_slli_epi64(split_bytes, 8);
-	__m128i recombined = _mm_or_si128(split_bytes, shifted_split_bytes);
-	__m128i low_byte = _mm_srli_epi64(bytes_to_decode, 56);
-	__m128i result_evens = _mm_or_si128(recombined, low_byte);
-	__m128i result = _mm_shuffle_epi8(result_evens,
-			_mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1,
-					-1));
-
-	_mm_storel_epi64(mout, result);
-	return consumed;
+	return len1 + len2;
 }
 
 
 // len_signed : number of ints we want to decode
-size_t masked_vbyte_decode(const uint8_t* in, uint32_t* out,
+static size_t masked_vbyte_decode(const uint8_t* in, uint32_t* out,
 		uint64_t length) {
 	size_t consumed = 0; // number of bytes read
 	uint64_t count = 0; // how many integers we have read so far
@@ -1254,7 +1417,7 @@ size_t masked_vbyte_decode(const uint8_t* in, uint32_t* out,
 
 // inputsize : number of input bytes we want to decode
 // returns the number of written ints
-size_t masked_vbyte_decode_fromcompressedsize(const uint8_t* in, uint32_t* out,
+static size_t masked_vbyte_decode_fromcompressedsize(const uint8_t* in, uint32_t* out,
 		size_t inputsize) {
 	size_t consumed = 0; // number of bytes read
 	uint32_t * initout = out;
@@ -1386,115 +1549,8 @@ size_t masked_vbyte_decode_fromcompressedsize(const uint8_t* in, uint32_t* out,
 }
 
 
-size_t read_ints(const uint8_t* in, uint32_t* out, int length) {
-	size_t consumed = 0;
-	int count;
-	for (count = 0; count + 15 < length;) {
-		int ints_read;
-		consumed += read_int_group(in + consumed, out + count, &ints_read);
-		count += ints_read;
-	}
-	for (; count < length; count++) {
-		consumed += read_int(in + consumed, out + count);
-	}
-	return consumed;
-}
-
-static int read_int_group_delta(const uint8_t* in, uint32_t* out,
-		int* ints_read, __m128i * prev) {
-
-	__m128i initial = _mm_lddqu_si128((const __m128i *) in);
-	__m128i * const mout = (__m128i *) out;
-
-	int mask = _mm_movemask_epi8(initial);
-	if (mask == 0) {
-		__m128i result;
-		result = _mm_cvtepi8_epi32(initial);
-		initial = _mm_srli_si128(initial, 4);
-		*prev = PrefixSum(result, *prev);
-		_mm_storeu_si128(mout, *prev);
-		result = _mm_cvtepi8_epi32(initial);
-		initial = _mm_srli_si128(initial, 4);
-		*prev = PrefixSum(result, *prev);
-		_mm_storeu_si128(mout + 1, *prev);
-		result = _mm_cvtepi8_epi32(initial);
-		initial = _mm_srli_si128(initial, 4);
-		*prev = PrefixSum(result, *prev);
-		_mm_storeu_si128(mout + 2, *prev);
-		result = _mm_cvtepi8_epi32(initial);
-		*prev = PrefixSum(result, *prev);
-		_mm_storeu_si128(mout + 3, *prev);
-		*ints_read = 16;
-		return 16;
-	}
-	int mask2 = mask & 0xFFF;
-	index_bytes_consumed combined = combined_lookup[mask2];
-
-	int index = combined.index;
-
-	__m128i shuffle_vector = vectors[index];
-	int consumed = combined.bytes_consumed;
-
-	if (index < 64) {
-		*ints_read = 6;
-		__m128i bytes_to_decode = _mm_shuffle_epi8(initial, shuffle_vector);
-		__m128i low_bytes = _mm_and_si128(bytes_to_decode,
-				_mm_set1_epi16(0x007F));
-		__m128i high_bytes = _mm_and_si128(bytes_to_decode,
-				_mm_set1_epi16(0x7F00));
-		__m128i high_bytes_shifted = _mm_srli_epi16(high_bytes, 1);
-		__m128i packed_result = _mm_or_si128(low_bytes, high_bytes_shifted);
-		__m128i unpacked_result_a = _mm_and_si128(packed_result,
-				_mm_set1_epi32(0x0000FFFF));
-		*prev = PrefixSum(unpacked_result_a, *prev);
-		_mm_storeu_si128(mout, *prev);
-		__m128i unpacked_result_b = _mm_srli_epi32(packed_result, 16);
-		*prev = PrefixSum2ints(unpacked_result_b, *prev);
-		_mm_storeu_si128(mout + 1, *prev);
-		return consumed;
-	}
-	if (index < 145) {
-
-		*ints_read = 4;
-
-		__m128i bytes_to_decode = _mm_shuffle_epi8(initial, shuffle_vector);
-		__m128i low_bytes = _mm_and_si128(bytes_to_decode,
-				_mm_set1_epi32(0x0000007F));
-		__m128i middle_bytes = _mm_and_si128(bytes_to_decode,
-				_mm_set1_epi32(0x00007F00));
-		__m128i high_bytes = _mm_and_si128(bytes_to_decode,
-				_mm_set1_epi32(0x007F0000));
-		__m128i middle_bytes_shifted = _mm_srli_epi32(middle_bytes, 1);
-		__m128i high_bytes_shifted = _mm_srli_epi32(high_bytes, 2);
-		__m128i low_middle = _mm_or_si128(low_bytes, middle_bytes_shifted);
-		__m128i result = _mm_or_si128(low_middle, high_bytes_shifted);
-		*prev = PrefixSum(result, *prev);
-		_mm_storeu_si128(mout, *prev);
-
-		return consumed;
-	}
-
-	*ints_read = 2;
-
-	__m128i data_bits = _mm_and_si128(initial, _mm_set1_epi8(0x7F));
-	__m128i bytes_to_decode = _mm_shuffle_epi8(data_bits, shuffle_vector);
-	__m128i split_bytes = _mm_mullo_epi16(bytes_to_decode,
-			_mm_setr_epi16(128, 64, 32, 16, 128, 64, 32, 16));
-	__m128i shifted_split_bytes = _mm_slli_epi64(split_bytes, 8);
-	__m128i recombined = _mm_or_si128(split_bytes, shifted_split_bytes);
-	__m128i low_byte = _mm_srli_epi64(bytes_to_decode, 56);
-	__m128i result_evens = _mm_or_si128(recombined, low_byte);
-	__m128i result = _mm_shuffle_epi8(result_evens,
-			_mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1,
-					-1));
-	*prev = PrefixSum2ints(result, *prev);
-	_mm_storeu_si128(mout, *prev);
-	return consumed;
-}
-
-
 // len_signed : number of ints we want to decode
-size_t masked_vbyte_decode_delta(const uint8_t* in, uint32_t* out,
+static size_t masked_vbyte_decode_delta(const uint8_t* in, uint32_t* out,
 		uint64_t length, uint32_t prev) {
 	//uint64_t length = (uint64_t) len_signed; // number of ints we want to decode
 	size_t consumed = 0; // number of bytes read
@@ -1620,29 +1676,9 @@ size_t masked_vbyte_decode_delta(const uint8_t* in, uint32_t* out,
 	return consumed;
 }
 
-size_t read_ints_delta(const uint8_t* in, uint32_t* out, int length,
-		uint32_t prev) {
-	__m128i mprev = _mm_set1_epi32(prev);
-	size_t consumed = 0;
-	int count;
-	for (count = 0; count + 15 < length;) {
-		int ints_read;
-		consumed += read_int_group_delta(in + consumed, out + count, &ints_read,
-				&mprev);
-		count += ints_read;
-	}
-	prev = _mm_extract_epi32(mprev, 3);
-	for (; count < length; count++) {
-		consumed += read_int_delta(in + consumed, out + count, &prev);
-	}
-	return consumed;
-}
-
-
-
 // inputsize : number of input bytes we want to decode
 // returns the number of written ints
-size_t masked_vbyte_decode_fromcompressedsize_delta(const uint8_t* in, uint32_t* out,
+static size_t masked_vbyte_decode_fromcompressedsize_delta(const uint8_t* in, uint32_t* out,
 		size_t inputsize, uint32_t prev) {
 	size_t consumed = 0; // number of bytes read
 	uint32_t * initout = out;
@@ -1776,6 +1812,81 @@ size_t masked_vbyte_decode_fromcompressedsize_delta(const uint8_t* in, uint32_t*
 }
 
 
+// length : number of ints we want to decode; if mprev is not NULL then
+// the ints are differentially coded
+static inline size_t masked_vbyte_decode64_impl(const uint8_t* in,
+		uint64_t* out, uint64_t length, __m128i* mprev) {
+	size_t consumed = 0; // number of bytes read
+	uint64_t count = 0; // how many integers we have read so far
+
+	uint64_t sig = 0;
+	int availablebytes = 0;
+	while (availablebytes + count < length) {
+		if (availablebytes < 16) {
+			if (availablebytes + count + 31 < length) {
+#ifdef __AVX2__
+				uint64_t newsigavx = (uint32_t) _mm256_movemask_epi8(_mm256_loadu_si256((__m256i *)(in + availablebytes + consumed)));
+				sig |= (newsigavx << availablebytes);
+#else
+				uint64_t newsig = _mm_movemask_epi8(
+						_mm_lddqu_si128(
+								(const __m128i *) (in + availablebytes
+										+ consumed)));
+				uint64_t newsig2 = _mm_movemask_epi8(
+						_mm_lddqu_si128(
+								(const __m128i *) (in + availablebytes + 16
+										+ consumed)));
+				sig |= (newsig << availablebytes)
+						| (newsig2 << (availablebytes + 16));
+#endif
+				availablebytes += 32;
+			} else if (availablebytes + count + 15 < length) {
+				uint64_t newsig = _mm_movemask_epi8(
+						_mm_lddqu_si128(
+								(const __m128i *) (in + availablebytes
+										+ consumed)));
+				sig |= newsig << availablebytes;
+				availablebytes += 16;
+			} else {
+				break;
+			}
+		}
+		uint64_t ints_read;
+		uint64_t eaten = masked_vbyte_read_group64(in + consumed,
+				out + count, sig, &ints_read, mprev);
+		consumed += eaten;
+		availablebytes -= eaten;
+		sig >>= eaten;
+		count += ints_read;
+	}
+	if (mprev) {
+		uint64_t prev = _mm_extract_epi64(*mprev, 1);
+		for (; count < length; count++) {
+			uint64_t delta;
+			consumed += read_int64(in + consumed, &delta);
+			prev += delta;
+			out[count] = prev;
+		}
+	}
+	else {
+		for (; count < length; count++) {
+			consumed += read_int64(in + consumed, out + count);
+		}
+	}
+	return consumed;
+}
+
+static size_t masked_vbyte_decode64(const uint8_t* in, uint64_t* out,
+		uint64_t length) {
+	return masked_vbyte_decode64_impl(in, out, length, NULL);
+}
+
+static size_t masked_vbyte_decode_delta64(const uint8_t* in, uint64_t* out,
+		uint64_t length, uint64_t prev) {
+	__m128i mprev = _mm_set1_epi64x((long long)prev);
+	return masked_vbyte_decode64_impl(in, out, length, &mprev);
+}
+
 
 static int8_t shuffle_mask_bytes1[16 * 16 ]  ALIGNED(16) = {
     0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
@@ -1932,7 +2043,7 @@ static int masked_vbyte_search_group_delta(const uint8_t *in, uint64_t *p,
 
 
 // returns the index of the matching key
-int masked_vbyte_search_delta(const uint8_t *in, uint64_t length, uint32_t prev,
+static int masked_vbyte_search_delta(const uint8_t *in, uint64_t length, uint32_t prev,
                               uint32_t key, uint32_t *presult) {
     size_t consumed = 0; // number of bytes read
     __m128i mprev = _mm_set1_epi32(prev);
@@ -2035,18 +2146,502 @@ int masked_vbyte_search_delta(const uint8_t *in, uint64_t length, uint32_t prev,
         }
     }
 
-    *presult = key + 1;
+    *presult = prev;
     return length;
 }
 
-static int8_t shuffle_mask_bytes2[16 * 16 ] ALIGNED(16) = {
-    0,1,2,3,0,0,0,0,0,0,0,0,0,0,0,0,
-    4,5,6,7,0,0,0,0,0,0,0,0,0,0,0,0,
-    8,9,10,11,0,0,0,0,0,0,0,0,0,0,0,0,
-    12,13,14,15,0,0,0,0,0,0,0,0,0,0,0,0,
-};
+/* return the position of |key| in |out|, if it is found */
+#define CHECK_EQUAL_AND_INCREMENT(i, out, key4)                             \
+      do {                                                                  \
+        uint32_t mmask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(out, key4))); \
+        if (mmask) {                                                        \
+          int offset;                                                       \
+          SIMDCOMP_CTZ(offset, mmask);                                      \
+          return (i + offset);                                              \
+        }                                                                   \
+        i += 4;                                                             \
+      } while (0)
 
-static const __m128i *shuffle_mask_extract = (__m128i *) shuffle_mask_bytes2;
+/* same as above, but only the lower two ints of |out| are valid */
+#define CHECK_EQUAL_AND_INCREMENT_2(i, out, key4)                           \
+      do {                                                                  \
+        uint32_t mmask = 3 & _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(out, key4))); \
+        if (mmask) {                                                        \
+          int offset;                                                       \
+          SIMDCOMP_CTZ(offset, mmask);                                      \
+          return (i + offset);                                              \
+        }                                                                   \
+        i += 2;                                                             \
+      } while (0)
+
+static int masked_vbyte_search_group(const uint8_t *in, uint64_t *p,
+        uint64_t mask, uint64_t *ints_read, int i, uint32_t key) {
+    __m128i initial = _mm_lddqu_si128((const __m128i *) (in));
+    __m128i key4 = _mm_set1_epi32(key);
+
+    if (!(mask & 0xFFFF)) {
+        __m128i result = _mm_cvtepi8_epi32(initial);
+        CHECK_EQUAL_AND_INCREMENT(i, result, key4);
+        initial = _mm_srli_si128(initial, 4);
+        result = _mm_cvtepi8_epi32(initial);
+        CHECK_EQUAL_AND_INCREMENT(i, result, key4);
+        initial = _mm_srli_si128(initial, 4);
+        result = _mm_cvtepi8_epi32(initial);
+        CHECK_EQUAL_AND_INCREMENT(i, result, key4);
+        initial = _mm_srli_si128(initial, 4);
+        result = _mm_cvtepi8_epi32(initial);
+        CHECK_EQUAL_AND_INCREMENT(i, result, key4);
+        *ints_read = 16;
+        *p = 16;
+        return (-1);
+    }
+
+    uint32_t low_12_bits = mask & 0xFFF;
+    // combine index and bytes consumed into a single lookup
+    index_bytes_consumed combined = combined_lookup[low_12_bits];
+    uint64_t consumed = combined.bytes_consumed;
+    uint8_t index = combined.index;
+
+    __m128i shuffle_vector = vectors[index];
+
+    if (index < 64) {
+        *ints_read = 6;
+        __m128i bytes_to_decode = _mm_shuffle_epi8(initial, shuffle_vector);
+        __m128i low_bytes = _mm_and_si128(bytes_to_decode,
+                                          _mm_set1_epi16(0x007F));
+        __m128i high_bytes = _mm_and_si128(bytes_to_decode,
+                                           _mm_set1_epi16(0x7F00));
+        __m128i high_bytes_shifted = _mm_srli_epi16(high_bytes, 1);
+        __m128i packed_result = _mm_or_si128(low_bytes, high_bytes_shifted);
+        __m128i unpacked_result_a = _mm_and_si128(packed_result,
+                                    _mm_set1_epi32(0x0000FFFF));
+        CHECK_EQUAL_AND_INCREMENT(i, unpacked_result_a, key4);
+        __m128i unpacked_result_b = _mm_srli_epi32(packed_result, 16);
+        CHECK_EQUAL_AND_INCREMENT_2(i, unpacked_result_b, key4);
+        *p = consumed;
+        return (-1);
+    }
+    if (index < 145) {
+
+        *ints_read = 4;
+
+        __m128i bytes_to_decode = _mm_shuffle_epi8(initial, shuffle_vector);
+        __m128i low_bytes = _mm_and_si128(bytes_to_decode,
+                                          _mm_set1_epi32(0x0000007F));
+        __m128i middle_bytes = _mm_and_si128(bytes_to_decode,
+                                             _mm_set1_epi32(0x00007F00));
+        __m128i high_bytes = _mm_and_si128(bytes_to_decode,
+                                           _mm_set1_epi32(0x007F0000));
+        __m128i middle_bytes_shifted = _mm_srli_epi32(middle_bytes, 1);
+        __m128i high_bytes_shifted = _mm_srli_epi32(high_bytes, 2);
+        __m128i low_middle = _mm_or_si128(low_bytes, middle_bytes_shifted);
+        __m128i result = _mm_or_si128(low_middle, high_bytes_shifted);
+        CHECK_EQUAL_AND_INCREMENT(i, result, key4);
+        *p = consumed;
+        return (-1);
+    }
+
+    *ints_read = 2;
+
+    __m128i data_bits = _mm_and_si128(initial, _mm_set1_epi8(0x7F));
+    __m128i bytes_to_decode = _mm_shuffle_epi8(data_bits, shuffle_vector);
+    __m128i split_bytes = _mm_mullo_epi16(bytes_to_decode,
+                                          _mm_setr_epi16(128, 64, 32, 16, 128, 64, 32, 16));
+    __m128i shifted_split_bytes = _mm_slli_epi64(split_bytes, 8);
+    __m128i recombined = _mm_or_si128(split_bytes, shifted_split_bytes);
+    __m128i low_byte = _mm_srli_epi64(bytes_to_decode, 56);
+    __m128i result_evens = _mm_or_si128(recombined, low_byte);
+    __m128i result = _mm_shuffle_epi8(result_evens,
+                                      _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1,
+                                              -1));
+    CHECK_EQUAL_AND_INCREMENT_2(i, result, key4);
+    *p = consumed;
+    return (-1);
+}
+
+// fills |sig| with the signature bits of the next 16 or 32 bytes, as long
+// as |length| guarantees that those bytes exist. Returns false if not
+// enough bytes are left.
+static inline int refill_signature(const uint8_t *in, uint64_t length,
+        size_t consumed, uint64_t count, uint64_t *sig, int *availablebytes) {
+    if (*availablebytes + count + 31 < length) {
+#ifdef __AVX2__
+        uint64_t newsigavx = (uint32_t) _mm256_movemask_epi8(_mm256_loadu_si256((__m256i *)(in + *availablebytes + consumed)));
+        *sig |= (newsigavx << *availablebytes);
+#else
+        uint64_t newsig = _mm_movemask_epi8(
+                              _mm_lddqu_si128(
+                                  (const __m128i *) (in + *availablebytes
+                                          + consumed)));
+        uint64_t newsig2 = _mm_movemask_epi8(
+                               _mm_lddqu_si128(
+                                   (const __m128i *) (in + *availablebytes + 16
+                                           + consumed)));
+        *sig |= (newsig << *availablebytes)
+                | (newsig2 << (*availablebytes + 16));
+#endif
+        *availablebytes += 32;
+        return 1;
+    }
+    if (*availablebytes + count + 15 < length) {
+        uint64_t newsig = _mm_movemask_epi8(
+                              _mm_lddqu_si128(
+                                  (const __m128i *) (in + *availablebytes
+                                          + consumed)));
+        *sig |= newsig << *availablebytes;
+        *availablebytes += 16;
+        return 1;
+    }
+    return 0;
+}
+
+// returns the index of the first value == key, or length
+static size_t masked_vbyte_search(const uint8_t *in, uint64_t length,
+                                  uint32_t key) {
+    size_t consumed = 0; // number of bytes read
+    uint64_t count = 0; // how many integers we have read so far
+    uint64_t sig = 0;
+    int availablebytes = 0;
+
+    while (availablebytes + count < length) {
+        if (availablebytes < 16
+                && !refill_signature(in, length, consumed, count, &sig,
+                                     &availablebytes))
+            break;
+
+        uint64_t ints_read = 0, bytes = 0;
+        int ret = masked_vbyte_search_group(in + consumed, &bytes,
+                  sig, &ints_read, 0, key);
+        if (ret >= 0)
+            return (count + ret);
+        consumed += bytes;
+        availablebytes -= bytes;
+        sig >>= bytes;
+        count += ints_read;
+    }
+    for (; count < length; count++) {
+        uint32_t out;
+        consumed += read_int(in + consumed, &out);
+        if (key == out)
+            return (count);
+    }
+    return length;
+}
+
+// returns the index of the first value == key, or length
+static size_t masked_vbyte_search64(const uint8_t *in, uint64_t length,
+                                    uint64_t key) {
+    size_t consumed = 0; // number of bytes read
+    uint64_t count = 0; // how many integers we have read so far
+    uint64_t sig = 0;
+    int availablebytes = 0;
+    __m128i key2 = _mm_set1_epi64x((long long)key);
+    uint64_t out[16];
+
+    while (availablebytes + count < length) {
+        if (availablebytes < 16
+                && !refill_signature(in, length, consumed, count, &sig,
+                                     &availablebytes))
+            break;
+
+        uint64_t ints_read;
+        uint64_t bytes = masked_vbyte_read_group64(in + consumed, out,
+                         sig, &ints_read, NULL);
+        uint64_t i;
+        for (i = 0; i + 1 < ints_read; i += 2) {
+            __m128i values = _mm_loadu_si128((const __m128i *) (out + i));
+            int mmask = _mm_movemask_pd(_mm_castsi128_pd(
+                            _mm_cmpeq_epi64(values, key2)));
+            if (mmask) {
+                int offset;
+                SIMDCOMP_CTZ(offset, mmask);
+                return (count + i + offset);
+            }
+        }
+        // an odd number of integers leaves one for a scalar compare
+        if (i < ints_read && out[i] == key)
+            return (count + i);
+        consumed += bytes;
+        availablebytes -= bytes;
+        sig >>= bytes;
+        count += ints_read;
+    }
+    for (; count < length; count++) {
+        uint64_t value;
+        consumed += read_int64(in + consumed, &value);
+        if (key == value)
+            return (count);
+    }
+    return length;
+}
+
+// returns the index of the first of the |ints| values in |buffer| which is
+// not less than |key|. The caller makes sure that such a value exists.
+static inline int lower_bound_group(const uint32_t *buffer, uint64_t ints,
+                                    uint32_t key) {
+    __m128i key4 = _mm_set1_epi32(key);
+    int i;
+    for (i = 0; i < (int) ints; i += 4) {
+        __m128i values = _mm_loadu_si128((const __m128i *) (buffer + i));
+        // values >= key (unsigned) <=> max(values, key) == values
+        __m128i ge = _mm_cmpeq_epi32(_mm_max_epu32(values, key4), values);
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(ge));
+        if (mask) {
+            int offset;
+            SIMDCOMP_CTZ(offset, mask);
+            return (i + offset);
+        }
+    }
+    return ((int) ints - 1); // not reached
+}
+
+// performs a lower bound search for each of the ascending |keys| and stores
+// the index of the found element (or length) in |positions| and its value
+// in |presults|
+static void masked_vbyte_search_many_delta(const uint8_t *in, uint64_t length,
+        uint32_t prev, const uint32_t *keys, size_t keycount,
+        size_t *positions, uint32_t *presults) {
+    size_t consumed = 0; // number of bytes read
+    __m128i mprev = _mm_set1_epi32(prev);
+    uint64_t count = 0; // how many integers we have read so far
+    uint64_t sig = 0;
+    int availablebytes = 0;
+    size_t k = 0; // the next key
+    uint32_t buffer[16] = {0};
+
+    while (k < keycount && availablebytes + count < length) {
+        if (availablebytes < 16
+                && !refill_signature(in, length, consumed, count, &sig,
+                                     &availablebytes))
+            break;
+
+        uint64_t ints_read;
+        uint64_t bytes = masked_vbyte_read_group_delta(in + consumed, buffer,
+                         sig, &ints_read, &mprev);
+        // all pending keys up to the last value of the group have their
+        // lower bound in this group
+        uint32_t last = buffer[ints_read - 1];
+        for (; k < keycount && keys[k] <= last; k++) {
+            int i = lower_bound_group(buffer, ints_read, keys[k]);
+            positions[k] = count + i;
+            presults[k] = buffer[i];
+        }
+        consumed += bytes;
+        availablebytes -= bytes;
+        sig >>= bytes;
+        count += ints_read;
+    }
+
+    prev = _mm_extract_epi32(mprev, 3);
+    for (; k < keycount && count < length; count++) {
+        uint32_t value;
+        consumed += read_int_delta(in + consumed, &value, &prev);
+        for (; k < keycount && keys[k] <= value; k++) {
+            positions[k] = count;
+            presults[k] = value;
+        }
+    }
+    for (; k < keycount; k++)
+        positions[k] = length;
+}
+
+// the 64bit version of masked_vbyte_search_many_delta
+static void masked_vbyte_search_many_delta64(const uint8_t *in,
+        uint64_t length, uint64_t prev, const uint64_t *keys, size_t keycount,
+        size_t *positions, uint64_t *presults) {
+    size_t consumed = 0; // number of bytes read
+    __m128i mprev = _mm_set1_epi64x((long long)prev);
+    uint64_t count = 0; // how many integers we have read so far
+    uint64_t sig = 0;
+    int availablebytes = 0;
+    size_t k = 0; // the next key
+    uint64_t buffer[16];
+
+    while (k < keycount && availablebytes + count < length) {
+        if (availablebytes < 16
+                && !refill_signature(in, length, consumed, count, &sig,
+                                     &availablebytes))
+            break;
+
+        uint64_t ints_read;
+        uint64_t bytes = masked_vbyte_read_group64(in + consumed, buffer,
+                         sig, &ints_read, &mprev);
+        uint64_t i = 0;
+        for (; k < keycount && keys[k] <= buffer[ints_read - 1]; k++) {
+            // the keys are ascending, therefore the search in the group
+            // continues where the previous key stopped
+            while (buffer[i] < keys[k])
+                i++;
+            positions[k] = count + i;
+            presults[k] = buffer[i];
+        }
+        consumed += bytes;
+        availablebytes -= bytes;
+        sig >>= bytes;
+        count += ints_read;
+    }
+
+    prev = _mm_extract_epi64(mprev, 1);
+    for (; k < keycount && count < length; count++) {
+        uint64_t delta;
+        consumed += read_int64(in + consumed, &delta);
+        prev += delta;
+        for (; k < keycount && keys[k] <= prev; k++) {
+            positions[k] = count;
+            presults[k] = prev;
+        }
+    }
+    for (; k < keycount; k++)
+        positions[k] = length;
+}
+
+// intersects the strictly increasing arrays |a| and |b| by comparing all
+// pairs of two blocks of 4 integers (see Lemire, Boytsov, Kurz: "SIMD
+// Compression and the Intersection of Sorted Integers"). Stops when less
+// than 4 integers are left in |a| or |b|, and stores how many integers
+// were processed in |pa| and |pb|. Returns the number of matches stored
+// in |out|.
+static size_t masked_vbyte_intersect(const uint32_t *a, size_t na,
+        const uint32_t *b, size_t nb, uint32_t *out, size_t *pa, size_t *pb) {
+    size_t i = 0, j = 0, count = 0;
+
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m128i va = _mm_loadu_si128((const __m128i *) (a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *) (b + j));
+        __m128i eq = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                        _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x39))),
+                    _mm_or_si128(
+                        _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x4E)),
+                        _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x93))));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+        while (mask) {
+            int lane;
+            SIMDCOMP_CTZ(lane, mask);
+            out[count++] = a[i + lane];
+            mask &= mask - 1;
+        }
+        uint32_t amax = a[i + 3];
+        uint32_t bmax = b[j + 3];
+        if (amax <= bmax)
+            i += 4;
+        if (bmax <= amax)
+            j += 4;
+    }
+    *pa = i;
+    *pb = j;
+    return count;
+}
+
+// the 64bit version of masked_vbyte_intersect, with blocks of 2 integers
+static size_t masked_vbyte_intersect64(const uint64_t *a, size_t na,
+        const uint64_t *b, size_t nb, uint64_t *out, size_t *pa, size_t *pb) {
+    size_t i = 0, j = 0, count = 0;
+
+    while (i + 2 <= na && j + 2 <= nb) {
+        __m128i va = _mm_loadu_si128((const __m128i *) (a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *) (b + j));
+        __m128i eq = _mm_or_si128(_mm_cmpeq_epi64(va, vb),
+                     _mm_cmpeq_epi64(va, _mm_shuffle_epi32(vb, 0x4E)));
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(eq));
+        if (mask & 1)
+            out[count++] = a[i];
+        if (mask & 2)
+            out[count++] = a[i + 1];
+        uint64_t amax = a[i + 1];
+        uint64_t bmax = b[j + 1];
+        if (amax <= bmax)
+            i += 2;
+        if (bmax <= amax)
+            j += 2;
+    }
+    *pa = i;
+    *pb = j;
+    return count;
+}
+
+// like masked_vbyte_intersect, but stores the integers of |a| which are
+// NOT in |b|. |pmatched| is a bitmap of the integers of the current block
+// of |a| which were already found in |b|; it is carried from one call to
+// the next, relative to the first integer of |a|.
+static size_t masked_vbyte_difference(const uint32_t *a, size_t na,
+        const uint32_t *b, size_t nb, uint32_t *out, size_t *pa, size_t *pb,
+        int *pmatched) {
+    size_t i = 0, j = 0, count = 0;
+    int matched = *pmatched;
+
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m128i va = _mm_loadu_si128((const __m128i *) (a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *) (b + j));
+        __m128i eq = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                        _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x39))),
+                    _mm_or_si128(
+                        _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x4E)),
+                        _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x93))));
+        matched |= _mm_movemask_ps(_mm_castsi128_ps(eq));
+        uint32_t amax = a[i + 3];
+        uint32_t bmax = b[j + 3];
+        if (amax <= bmax) {
+            int mask = ~matched & 0xF;
+            while (mask) {
+                int lane;
+                SIMDCOMP_CTZ(lane, mask);
+                out[count++] = a[i + lane];
+                mask &= mask - 1;
+            }
+            matched = 0;
+            i += 4;
+        }
+        if (bmax <= amax)
+            j += 4;
+    }
+    *pa = i;
+    *pb = j;
+    *pmatched = matched;
+    return count;
+}
+
+// the 64bit version of masked_vbyte_difference, with blocks of 2 integers
+static size_t masked_vbyte_difference64(const uint64_t *a, size_t na,
+        const uint64_t *b, size_t nb, uint64_t *out, size_t *pa, size_t *pb,
+        int *pmatched) {
+    size_t i = 0, j = 0, count = 0;
+    int matched = *pmatched;
+
+    while (i + 2 <= na && j + 2 <= nb) {
+        __m128i va = _mm_loadu_si128((const __m128i *) (a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *) (b + j));
+        __m128i eq = _mm_or_si128(_mm_cmpeq_epi64(va, vb),
+                     _mm_cmpeq_epi64(va, _mm_shuffle_epi32(vb, 0x4E)));
+        matched |= _mm_movemask_pd(_mm_castsi128_pd(eq));
+        uint64_t amax = a[i + 1];
+        uint64_t bmax = b[j + 1];
+        if (amax <= bmax) {
+            if (!(matched & 1))
+                out[count++] = a[i];
+            if (!(matched & 2))
+                out[count++] = a[i + 1];
+            matched = 0;
+            i += 2;
+        }
+        if (bmax <= amax)
+            j += 2;
+    }
+    *pa = i;
+    *pb = j;
+    *pmatched = matched;
+    return count;
+}
+
+static int8_t shuffle_mask_bytes2[16 * 16 ] ALIGNED(16) = {
+    0,1,2,3,0,0,0,0,0,0,0,0,0,0,0,0,
+    4,5,6,7,0,0,0,0,0,0,0,0,0,0,0,0,
+    8,9,10,11,0,0,0,0,0,0,0,0,0,0,0,0,
+    12,13,14,15,0,0,0,0,0,0,0,0,0,0,0,0,
+};
+
+static const __m128i *shuffle_mask_extract = (__m128i *) shuffle_mask_bytes2;
 
 static uint32_t branchlessextract (__m128i out, int i)  {
     return _mm_cvtsi128_si32(_mm_shuffle_epi8(out,shuffle_mask_extract[i]));
@@ -2166,7 +2761,299 @@ static int masked_vbyte_select_group_delta(const uint8_t *in, uint64_t *p,
 
 
 
-uint32_t masked_vbyte_select_delta(const uint8_t *in, uint64_t length,
+// returns the signature (the high bit of each byte) of 64 bytes
+static inline uint64_t load_signature64(const uint8_t *in) {
+#ifdef __AVX2__
+    uint64_t low = (uint32_t) _mm256_movemask_epi8(
+                       _mm256_loadu_si256((const __m256i *) in));
+    uint64_t high = (uint32_t) _mm256_movemask_epi8(
+                        _mm256_loadu_si256((const __m256i *) (in + 32)));
+    return low | (high << 32);
+#else
+    uint64_t sig0 = _mm_movemask_epi8(_mm_lddqu_si128((const __m128i *) in));
+    uint64_t sig1 = _mm_movemask_epi8(
+                        _mm_lddqu_si128((const __m128i *) (in + 16)));
+    uint64_t sig2 = _mm_movemask_epi8(
+                        _mm_lddqu_si128((const __m128i *) (in + 32)));
+    uint64_t sig3 = _mm_movemask_epi8(
+                        _mm_lddqu_si128((const __m128i *) (in + 48)));
+    return sig0 | (sig1 << 16) | (sig2 << 32) | (sig3 << 48);
+#endif
+}
+
+// like masked_vbyte_select_group_delta, but without delta decoding. Groups
+// which do not contain |slot| are skipped by looking only at the signature
+// mask; nothing is decoded for them.
+static int masked_vbyte_select_group(const uint8_t *in, uint64_t *p,
+        uint64_t mask, uint64_t *ints_read, int slot, uint32_t *presult) {
+    int i = 0;
+
+    if (!(mask & 0xFFFF)) {
+        *ints_read = 16;
+        *p = 16;
+        if (slot >= 16)
+            return (0);
+        *presult = in[slot];
+        return (1);
+    }
+
+    uint32_t low_12_bits = mask & 0xFFF;
+    // combine index and bytes consumed into a single lookup
+    index_bytes_consumed combined = combined_lookup[low_12_bits];
+    uint64_t consumed = combined.bytes_consumed;
+    uint8_t index = combined.index;
+    *p = consumed;
+
+    if (index < 64) {
+        *ints_read = 6;
+        if (slot >= 6)
+            return (0);
+        __m128i initial = _mm_lddqu_si128((const __m128i *) (in));
+        __m128i bytes_to_decode = _mm_shuffle_epi8(initial, vectors[index]);
+        __m128i low_bytes = _mm_and_si128(bytes_to_decode,
+                                          _mm_set1_epi16(0x007F));
+        __m128i high_bytes = _mm_and_si128(bytes_to_decode,
+                                           _mm_set1_epi16(0x7F00));
+        __m128i high_bytes_shifted = _mm_srli_epi16(high_bytes, 1);
+        __m128i packed_result = _mm_or_si128(low_bytes, high_bytes_shifted);
+        __m128i unpacked_result_a = _mm_and_si128(packed_result,
+                                    _mm_set1_epi32(0x0000FFFF));
+        CHECK_SELECT(i, unpacked_result_a, slot, presult);
+        __m128i unpacked_result_b = _mm_srli_epi32(packed_result, 16);
+        CHECK_SELECT_2(i, unpacked_result_b, slot, presult);
+        return (0);
+    }
+    if (index < 145) {
+        *ints_read = 4;
+        if (slot >= 4)
+            return (0);
+        __m128i initial = _mm_lddqu_si128((const __m128i *) (in));
+        __m128i bytes_to_decode = _mm_shuffle_epi8(initial, vectors[index]);
+        __m128i low_bytes = _mm_and_si128(bytes_to_decode,
+                                          _mm_set1_epi32(0x0000007F));
+        __m128i middle_bytes = _mm_and_si128(bytes_to_decode,
+                                             _mm_set1_epi32(0x00007F00));
+        __m128i high_bytes = _mm_and_si128(bytes_to_decode,
+                                           _mm_set1_epi32(0x007F0000));
+        __m128i middle_bytes_shifted = _mm_srli_epi32(middle_bytes, 1);
+        __m128i high_bytes_shifted = _mm_srli_epi32(high_bytes, 2);
+        __m128i low_middle = _mm_or_si128(low_bytes, middle_bytes_shifted);
+        __m128i result = _mm_or_si128(low_middle, high_bytes_shifted);
+        CHECK_SELECT(i, result, slot, presult);
+        return (0);
+    }
+
+    *ints_read = 2;
+    if (slot >= 2)
+        return (0);
+    __m128i initial = _mm_lddqu_si128((const __m128i *) (in));
+    __m128i data_bits = _mm_and_si128(initial, _mm_set1_epi8(0x7F));
+    __m128i bytes_to_decode = _mm_shuffle_epi8(data_bits, vectors[index]);
+    __m128i split_bytes = _mm_mullo_epi16(bytes_to_decode,
+                                          _mm_setr_epi16(128, 64, 32, 16, 128, 64, 32, 16));
+    __m128i shifted_split_bytes = _mm_slli_epi64(split_bytes, 8);
+    __m128i recombined = _mm_or_si128(split_bytes, shifted_split_bytes);
+    __m128i low_byte = _mm_srli_epi64(bytes_to_decode, 56);
+    __m128i result_evens = _mm_or_si128(recombined, low_byte);
+    __m128i result = _mm_shuffle_epi8(result_evens,
+                                      _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1,
+                                              -1));
+    CHECK_SELECT_2(i, result, slot, presult);
+    return (0);
+}
+
+// returns the value at index |slot|. Unlike the other kernels, |length| is
+// the size of |in| in bytes.
+static uint32_t masked_vbyte_select(const uint8_t *in, uint64_t length,
+                                    size_t slot) {
+    size_t consumed = 0; // number of bytes read
+    uint64_t count = 0; // how many integers we have read so far
+    uint64_t sig = 0;
+    int availablebytes = 0;
+
+    // skip blocks of 64 bytes which do not contain the slot; they are not
+    // decoded, only their terminating bytes are counted
+    size_t block = 0;
+    uint64_t last_ends = 0;
+    while (block + 64 <= length) {
+        uint64_t ends = ~load_signature64(in + block);
+        uint32_t ints;
+        SIMDCOMP_POPCOUNT64(ints, ends);
+        if (ints == 0 || count + ints > slot)
+            break;
+        count += ints;
+        block += 64;
+        last_ends = ends;
+    }
+    if (block > 0) {
+        // continue with the integer after the last terminating byte
+        uint32_t continuations;
+        SIMDCOMP_CLZ64(continuations, last_ends);
+        consumed = block - continuations;
+    }
+
+    while (count <= slot) {
+        // |length| is a byte count, therefore |consumed| is passed as the
+        // lower bound
+        if (availablebytes < 16
+                && !refill_signature(in, length, consumed, consumed, &sig,
+                                     &availablebytes))
+            break;
+
+        uint32_t result;
+        uint64_t ints_read, bytes;
+        int remaining = slot - count < 16 ? (int) (slot - count) : 16;
+        if (masked_vbyte_select_group(in + consumed, &bytes, sig,
+                                      &ints_read, remaining, &result))
+            return (result);
+        consumed += bytes;
+        availablebytes -= bytes;
+        sig >>= bytes;
+        count += ints_read;
+    }
+
+    uint32_t out = 0;
+    for (; count < slot + 1; count++)
+        consumed += read_int(in + consumed, &out);
+    return out;
+}
+
+// returns the number of bytes of the next group without decoding it, and
+// stores the number of its integers in |ints_read|
+static inline uint64_t masked_vbyte_skip_group(uint64_t mask,
+        uint64_t *ints_read) {
+    if (!(mask & 0xFFFF)) {
+        *ints_read = 16;
+        return 16;
+    }
+    index_bytes_consumed combined = combined_lookup[mask & 0xFFF];
+    *ints_read = combined.index < 64 ? 6 : combined.index < 145 ? 4 : 2;
+    return combined.bytes_consumed;
+}
+
+// stores the values at the ascending indices |slots| in |out|; with
+// differential coding if |mprev| is not NULL
+static inline void masked_vbyte_select_many_impl(const uint8_t *in,
+        const size_t *slots, size_t length, uint32_t *out, __m128i *mprev) {
+    size_t consumed = 0; // number of bytes read
+    uint64_t count = 0; // how many integers we have read so far
+    uint64_t sig = 0;
+    int availablebytes = 0;
+    size_t k = 0; // the next slot
+    uint32_t buffer[16];
+
+    if (length == 0)
+        return;
+
+    // all integers up to the last slot exist
+    uint64_t needed = slots[length - 1] + 1;
+
+    while (k < length && availablebytes + count < needed) {
+        if (availablebytes < 16
+                && !refill_signature(in, needed, consumed, count, &sig,
+                                     &availablebytes))
+            break;
+
+        uint64_t ints_read, bytes;
+        if (mprev)
+            bytes = masked_vbyte_read_group_delta(in + consumed, buffer, sig,
+                                                  &ints_read, mprev);
+        else {
+            // skip the group if it does not contain the next slot
+            bytes = masked_vbyte_skip_group(sig, &ints_read);
+            if (slots[k] < count + ints_read)
+                masked_vbyte_read_group(in + consumed, buffer, sig,
+                                        &ints_read);
+        }
+        for (; k < length && slots[k] < count + ints_read; k++)
+            out[k] = buffer[slots[k] - count];
+        consumed += bytes;
+        availablebytes -= bytes;
+        sig >>= bytes;
+        count += ints_read;
+    }
+
+    uint32_t prev = mprev ? (uint32_t) _mm_extract_epi32(*mprev, 3) : 0;
+    for (; k < length; count++) {
+        uint32_t value;
+        if (mprev)
+            consumed += read_int_delta(in + consumed, &value, &prev);
+        else
+            consumed += read_int(in + consumed, &value);
+        for (; k < length && slots[k] == count; k++)
+            out[k] = value;
+    }
+}
+
+static void masked_vbyte_select_many(const uint8_t *in, const size_t *slots,
+                                     size_t length, uint32_t *out) {
+    masked_vbyte_select_many_impl(in, slots, length, out, NULL);
+}
+
+static void masked_vbyte_select_many_delta(const uint8_t *in, uint32_t prev,
+        const size_t *slots, size_t length, uint32_t *out) {
+    __m128i mprev = _mm_set1_epi32(prev);
+    masked_vbyte_select_many_impl(in, slots, length, out, &mprev);
+}
+
+// the 64bit version of masked_vbyte_select_many_impl
+static inline void masked_vbyte_select_many64_impl(const uint8_t *in,
+        const size_t *slots, size_t length, uint64_t *out, __m128i *mprev) {
+    size_t consumed = 0; // number of bytes read
+    uint64_t count = 0; // how many integers we have read so far
+    uint64_t sig = 0;
+    int availablebytes = 0;
+    size_t k = 0; // the next slot
+    uint64_t buffer[16];
+
+    if (length == 0)
+        return;
+
+    // all integers up to the last slot exist
+    uint64_t needed = slots[length - 1] + 1;
+
+    while (k < length && availablebytes + count < needed) {
+        if (availablebytes < 16
+                && !refill_signature(in, needed, consumed, count, &sig,
+                                     &availablebytes))
+            break;
+
+        uint64_t ints_read;
+        uint64_t bytes = masked_vbyte_read_group64(in + consumed, buffer,
+                         sig, &ints_read, mprev);
+        for (; k < length && slots[k] < count + ints_read; k++)
+            out[k] = buffer[slots[k] - count];
+        consumed += bytes;
+        availablebytes -= bytes;
+        sig >>= bytes;
+        count += ints_read;
+    }
+
+    uint64_t prev = mprev ? (uint64_t) _mm_extract_epi64(*mprev, 1) : 0;
+    for (; k < length; count++) {
+        uint64_t value;
+        consumed += read_int64(in + consumed, &value);
+        if (mprev) {
+            prev += value;
+            value = prev;
+        }
+        for (; k < length && slots[k] == count; k++)
+            out[k] = value;
+    }
+}
+
+static void masked_vbyte_select_many64(const uint8_t *in,
+        const size_t *slots, size_t length, uint64_t *out) {
+    masked_vbyte_select_many64_impl(in, slots, length, out, NULL);
+}
+
+static void masked_vbyte_select_many_delta64(const uint8_t *in,
+        uint64_t prev, const size_t *slots, size_t length, uint64_t *out) {
+    __m128i mprev = _mm_set1_epi64x((long long)prev);
+    masked_vbyte_select_many64_impl(in, slots, length, out, &mprev);
+}
+
+static uint32_t masked_vbyte_select_delta(const uint8_t *in, uint64_t length,
                                    uint32_t prev, size_t slot) {
     size_t consumed = 0; // number of bytes read
     __m128i mprev = _mm_set1_epi32(prev);
@@ -2300,3 +3187,104 @@ uint32_t masked_vbyte_select_delta(const uint8_t *in, uint64_t length,
 
     return prev;
 }
+
+// every integer ends with exactly one byte which has the high bit cleared;
+// returns the number of these bytes in |in|. |length| is in bytes.
+static size_t masked_vbyte_count(const uint8_t *in, uint64_t length) {
+    size_t consumed = 0;
+    size_t count = 0;
+
+    for (; consumed + 64 <= length; consumed += 64) {
+        uint32_t continuations;
+        SIMDCOMP_POPCOUNT64(continuations, load_signature64(in + consumed));
+        count += 64 - continuations;
+    }
+    for (; consumed < length; consumed++)
+        count += (in[consumed] & 0x80) == 0;
+    return count;
+}
+
+// returns the byte offset of the integer at index |slot|, or |length| if
+// there are not enough integers. |length| is in bytes.
+static size_t masked_vbyte_locate(const uint8_t *in, uint64_t length,
+                                  size_t slot) {
+    size_t consumed = 0;
+
+    if (slot == 0)
+        return 0;
+
+    // the integer starts right after the |slot|th terminating byte
+    for (; consumed + 64 <= length; consumed += 64) {
+        uint64_t ends = ~load_signature64(in + consumed);
+        uint32_t count;
+        SIMDCOMP_POPCOUNT64(count, ends);
+        if (count >= slot) {
+            uint32_t offset;
+            for (; slot > 1; slot--)
+                ends &= ends - 1; // clear the lowest bit
+            SIMDCOMP_CTZ64(offset, ends);
+            return consumed + offset + 1;
+        }
+        slot -= count;
+    }
+    for (; consumed < length; consumed++) {
+        if ((in[consumed] & 0x80) == 0 && --slot == 0)
+            return consumed + 1;
+    }
+    return length;
+}
+
+// decodes the next group of 2 to 16 integers with differential coding
+// starting at |*prev|, which is updated; stores the number of integers in
+// |ints_read| and returns the number of bytes read. 16 bytes are loaded from
+// |in|, and up to 16 integers are written to |out|.
+static uint64_t masked_vbyte_decode_group_delta(const uint8_t *in,
+        uint32_t *out, uint32_t *prev, uint64_t *ints_read) {
+    uint64_t sig = (uint32_t) _mm_movemask_epi8(
+                       _mm_lddqu_si128((const __m128i *) in));
+    __m128i mprev = _mm_set1_epi32(*prev);
+    uint64_t bytes = masked_vbyte_read_group_delta(in, out, sig, ints_read,
+                     &mprev);
+    *prev = (uint32_t) _mm_extract_epi32(mprev, 3);
+    return bytes;
+}
+
+// the 64bit version of masked_vbyte_decode_group_delta
+static uint64_t masked_vbyte_decode_group_delta64(const uint8_t *in,
+        uint64_t *out, uint64_t *prev, uint64_t *ints_read) {
+    uint64_t sig = (uint32_t) _mm_movemask_epi8(
+                       _mm_lddqu_si128((const __m128i *) in));
+    __m128i mprev = _mm_set1_epi64x((long long)*prev);
+    uint64_t bytes = masked_vbyte_read_group64(in, out, sig, ints_read,
+                     &mprev);
+    *prev = (uint64_t) _mm_extract_epi64(mprev, 1);
+    return bytes;
+}
+
+const masked_vbyte_kernels MASKEDVBYTE_CONCAT(masked_vbyte_kernels, MASKEDVBYTE_ISA) = {
+    masked_vbyte_decode,
+    masked_vbyte_decode_delta,
+    masked_vbyte_decode_fromcompressedsize,
+    masked_vbyte_decode_fromcompressedsize_delta,
+    masked_vbyte_decode64,
+    masked_vbyte_decode_delta64,
+    masked_vbyte_select_delta,
+    masked_vbyte_search_delta,
+    masked_vbyte_search,
+    masked_vbyte_search64,
+    masked_vbyte_select,
+    masked_vbyte_count,
+    masked_vbyte_locate,
+    masked_vbyte_select_many,
+    masked_vbyte_select_many_delta,
+    masked_vbyte_select_many64,
+    masked_vbyte_select_many_delta64,
+    masked_vbyte_search_many_delta,
+    masked_vbyte_search_many_delta64,
+    masked_vbyte_intersect,
+    masked_vbyte_intersect64,
+    masked_vbyte_difference,
+    masked_vbyte_difference64,
+    masked_vbyte_decode_group_delta,
+    masked_vbyte_decode_group_delta64
+};
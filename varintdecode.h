@@ -10,27 +10,108 @@
 extern "C" {
 #endif
 
-// Read "length" 32-bit integers in varint format from in, storing the result in out.  Returns the number of bytes read.
-size_t masked_vbyte_decode(const uint8_t* in, uint32_t* out, uint64_t length);
+// varintdecode.c is compiled once per instruction set (SSE4.1, AVX and AVX2).
+// Each build exports its kernels through one of these tables; the caller
+// picks the best table that is supported by the CPU at run-time.
+typedef struct masked_vbyte_kernels {
+	// Read "length" 32-bit integers in varint format from in, storing the result in out.  Returns the number of bytes read.
+	size_t (*decode)(const uint8_t* in, uint32_t* out, uint64_t length);
 
-// Read "length" 32-bit integers in varint format from in, storing the result in out with differential coding starting at prev.  Setting prev to zero is a good default. Returns the number of bytes read.
-size_t masked_vbyte_decode_delta(const uint8_t* in, uint32_t* out, uint64_t length, uint32_t  prev);
+	// Read "length" 32-bit integers in varint format from in, storing the result in out with differential coding starting at prev.  Setting prev to zero is a good default. Returns the number of bytes read.
+	size_t (*decode_delta)(const uint8_t* in, uint32_t* out, uint64_t length, uint32_t  prev);
 
-// Read 32-bit integers in varint format from in, reading inputsize bytes, storing the result in out. Returns the number of integers read.
-size_t masked_vbyte_decode_fromcompressedsize(const uint8_t* in, uint32_t* out,
-		size_t inputsize);
+	// Read 32-bit integers in varint format from in, reading inputsize bytes, storing the result in out. Returns the number of integers read.
+	size_t (*decode_fromcompressedsize)(const uint8_t* in, uint32_t* out,
+			size_t inputsize);
 
-// Read 32-bit integers in varint format from in, reading inputsize bytes, storing the result in out with differential coding starting at prev. Setting prev to zero is a good default. Returns the number of integers read.
-size_t masked_vbyte_decode_fromcompressedsize_delta(const uint8_t* in, uint32_t* out,
-		size_t inputsize, uint32_t  prev);
+	// Read 32-bit integers in varint format from in, reading inputsize bytes, storing the result in out with differential coding starting at prev. Setting prev to zero is a good default. Returns the number of integers read.
+	size_t (*decode_fromcompressedsize_delta)(const uint8_t* in, uint32_t* out,
+			size_t inputsize, uint32_t  prev);
 
-// assuming that the data was differentially-coded, retrieve one particular value (at location slot)
-uint32_t masked_vbyte_select_delta(const uint8_t *in, uint64_t length,
-                    uint32_t prev, size_t slot);
+	// Read "length" 64-bit integers in varint format from in, storing the result in out.  Returns the number of bytes read.
+	size_t (*decode64)(const uint8_t* in, uint64_t* out, uint64_t length);
 
-// return the position of the first value >= key, assumes differential-coded values
-int masked_vbyte_search_delta(const uint8_t *in, uint64_t length, uint32_t prev,
-                    uint32_t key, uint32_t *presult);
+	// Read "length" 64-bit integers in varint format from in, storing the result in out with differential coding starting at prev.  Setting prev to zero is a good default. Returns the number of bytes read.
+	size_t (*decode_delta64)(const uint8_t* in, uint64_t* out, uint64_t length, uint64_t prev);
+
+	// assuming that the data was differentially-coded, retrieve one particular value (at location slot)
+	uint32_t (*select_delta)(const uint8_t *in, uint64_t length,
+			uint32_t prev, size_t slot);
+
+	// return the position of the first value >= key, assumes differential-coded values
+	int (*search_delta)(const uint8_t *in, uint64_t length, uint32_t prev,
+			uint32_t key, uint32_t *presult);
+
+	// return the position of the first value == key, or length if the key is not found
+	size_t (*search)(const uint8_t *in, uint64_t length, uint32_t key);
+
+	// return the position of the first value == key, or length if the key is not found
+	size_t (*search64)(const uint8_t *in, uint64_t length, uint64_t key);
+
+	// return the value at index slot; length is the size of in (in bytes)
+	uint32_t (*select)(const uint8_t *in, uint64_t length, size_t slot);
+
+	// return the number of integers in in; length is the size of in (in bytes)
+	size_t (*count)(const uint8_t *in, uint64_t length);
+
+	// return the byte offset of the integer at index slot, or length
+	size_t (*locate)(const uint8_t *in, uint64_t length, size_t slot);
+
+	// store the 32-bit values at the ascending indices slots[0..length) in out
+	void (*select_many)(const uint8_t *in, const size_t *slots, size_t length,
+			uint32_t *out);
+
+	// like select_many, but with differential coding starting at prev
+	void (*select_many_delta)(const uint8_t *in, uint32_t prev,
+			const size_t *slots, size_t length, uint32_t *out);
+
+	// store the 64-bit values at the ascending indices slots[0..length) in out
+	void (*select_many64)(const uint8_t *in, const size_t *slots,
+			size_t length, uint64_t *out);
+
+	// like select_many64, but with differential coding starting at prev
+	void (*select_many_delta64)(const uint8_t *in, uint64_t prev,
+			const size_t *slots, size_t length, uint64_t *out);
+
+	// lower bound search for the ascending keys[0..keycount) in "length" 32-bit integers with differential coding starting at prev; stores the positions (or length) and the found values
+	void (*search_many_delta)(const uint8_t *in, uint64_t length,
+			uint32_t prev, const uint32_t *keys, size_t keycount,
+			size_t *positions, uint32_t *presults);
+
+	// the 64-bit version of search_many_delta
+	void (*search_many_delta64)(const uint8_t *in, uint64_t length,
+			uint64_t prev, const uint64_t *keys, size_t keycount,
+			size_t *positions, uint64_t *presults);
+
+	// intersect the strictly increasing arrays a and b in blocks of 4 until less than 4 integers are left in one of them; stores the number of processed integers in pa and pb. Returns the number of matches written to out.
+	size_t (*intersect)(const uint32_t *a, size_t na, const uint32_t *b,
+			size_t nb, uint32_t *out, size_t *pa, size_t *pb);
+
+	// the 64-bit version of intersect, with blocks of 2
+	size_t (*intersect64)(const uint64_t *a, size_t na, const uint64_t *b,
+			size_t nb, uint64_t *out, size_t *pa, size_t *pb);
+
+	// like intersect, but writes the integers of a which are not in b to out. pmatched is a bitmap of the integers in the current block of a which were already found in b; it is carried over to the next call.
+	size_t (*difference)(const uint32_t *a, size_t na, const uint32_t *b,
+			size_t nb, uint32_t *out, size_t *pa, size_t *pb, int *pmatched);
+
+	// the 64-bit version of difference, with blocks of 2
+	size_t (*difference64)(const uint64_t *a, size_t na, const uint64_t *b,
+			size_t nb, uint64_t *out, size_t *pa, size_t *pb, int *pmatched);
+
+	// decode the next group of 2 to 16 integers to out, with differential coding starting at *prev, which is updated. Loads 16 bytes from in; stores the number of integers in ints_read and returns the number of bytes read.
+	uint64_t (*decode_group_delta)(const uint8_t *in, uint32_t *out,
+			uint32_t *prev, uint64_t *ints_read);
+
+	// the 64-bit version of decode_group_delta
+	uint64_t (*decode_group_delta64)(const uint8_t *in, uint64_t *out,
+			uint64_t *prev, uint64_t *ints_read);
+} masked_vbyte_kernels;
+
+// The kernels compiled with -msse4.1, -mavx and -mavx2
+extern const masked_vbyte_kernels masked_vbyte_kernels_sse41;
+extern const masked_vbyte_kernels masked_vbyte_kernels_avx;
+extern const masked_vbyte_kernels masked_vbyte_kernels_avx2;
 
 #ifdef __cplusplus
 } // extern "C"
@@ -0,0 +1,654 @@
+#include "varintencode.h"
+
+#include <x86intrin.h>
+
+// The build compiles this file once per instruction set, i.e. with
+// "-msse4.1 -DMASKEDVBYTE_ISA=sse41", "-mavx -DMASKEDVBYTE_ISA=avx" and
+// "-mavx2 -DMASKEDVBYTE_ISA=avx2"
+#ifndef MASKEDVBYTE_ISA
+#  define MASKEDVBYTE_ISA avx
+#endif
+
+#define MASKEDVBYTE_CONCAT_(a, b) a ## _ ## b
+#define MASKEDVBYTE_CONCAT(a, b) MASKEDVBYTE_CONCAT_(a, b)
+
+#if defined(_MSC_VER)
+#define ALIGNED(x) __declspec(align(x))
+#else
+#if defined(__GNUC__)
+#define ALIGNED(x) __attribute__ ((aligned(x)))
+#endif
+#endif
+
+
+// moves the encoded bytes of four 32-bit lanes next to each other; indexed
+// by the byte lengths of the four lanes (2 bits per lane, length - 1)
+static const int8_t encode_shuffle_rawbytes[] ALIGNED(0x1000) = {
+	 0,  4,  8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 0
+	 0,  1,  4,  8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 1
+	 0,  1,  2,  4,  8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 2
+	 0,  1,  2,  3,  4,  8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 3
+	 0,  4,  5,  8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 4
+	 0,  1,  4,  5,  8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 5
+	 0,  1,  2,  4,  5,  8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 6
+	 0,  1,  2,  3,  4,  5,  8, 12, -1, -1, -1, -1, -1, -1, -1, -1,  // 7
+	 0,  4,  5,  6,  8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 8
+	 0,  1,  4,  5,  6,  8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 9
+	 0,  1,  2,  4,  5,  6,  8, 12, -1, -1, -1, -1, -1, -1, -1, -1,  // 10
+	 0,  1,  2,  3,  4,  5,  6,  8, 12, -1, -1, -1, -1, -1, -1, -1,  // 11
+	 0,  4,  5,  6,  7,  8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 12
+	 0,  1,  4,  5,  6,  7,  8, 12, -1, -1, -1, -1, -1, -1, -1, -1,  // 13
+	 0,  1,  2,  4,  5,  6,  7,  8, 12, -1, -1, -1, -1, -1, -1, -1,  // 14
+	 0,  1,  2,  3,  4,  5,  6,  7,  8, 12, -1, -1, -1, -1, -1, -1,  // 15
+	 0,  4,  8,  9, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 16
+	 0,  1,  4,  8,  9, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 17
+	 0,  1,  2,  4,  8,  9, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 18
+	 0,  1,  2,  3,  4,  8,  9, 12, -1, -1, -1, -1, -1, -1, -1, -1,  // 19
+	 0,  4,  5,  8,  9, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 20
+	 0,  1,  4,  5,  8,  9, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 21
+	 0,  1,  2,  4,  5,  8,  9, 12, -1, -1, -1, -1, -1, -1, -1, -1,  // 22
+	 0,  1,  2,  3,  4,  5,  8,  9, 12, -1, -1, -1, -1, -1, -1, -1,  // 23
+	 0,  4,  5,  6,  8,  9, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 24
+	 0,  1,  4,  5,  6,  8,  9, 12, -1, -1, -1, -1, -1, -1, -1, -1,  // 25
+	 0,  1,  2,  4,  5,  6,  8,  9, 12, -1, -1, -1, -1, -1, -1, -1,  // 26
+	 0,  1,  2,  3,  4,  5,  6,  8,  9, 12, -1, -1, -1, -1, -1, -1,  // 27
+	 0,  4,  5,  6,  7,  8,  9, 12, -1, -1, -1, -1, -1, -1, -1, -1,  // 28
+	 0,  1,  4,  5,  6,  7,  8,  9, 12, -1, -1, -1, -1, -1, -1, -1,  // 29
+	 0,  1,  2,  4,  5,  6,  7,  8,  9, 12, -1, -1, -1, -1, -1, -1,  // 30
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 12, -1, -1, -1, -1, -1,  // 31
+	 0,  4,  8,  9, 10, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 32
+	 0,  1,  4,  8,  9, 10, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 33
+	 0,  1,  2,  4,  8,  9, 10, 12, -1, -1, -1, -1, -1, -1, -1, -1,  // 34
+	 0,  1,  2,  3,  4,  8,  9, 10, 12, -1, -1, -1, -1, -1, -1, -1,  // 35
+	 0,  4,  5,  8,  9, 10, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 36
+	 0,  1,  4,  5,  8,  9, 10, 12, -1, -1, -1, -1, -1, -1, -1, -1,  // 37
+	 0,  1,  2,  4,  5,  8,  9, 10, 12, -1, -1, -1, -1, -1, -1, -1,  // 38
+	 0,  1,  2,  3,  4,  5,  8,  9, 10, 12, -1, -1, -1, -1, -1, -1,  // 39
+	 0,  4,  5,  6,  8,  9, 10, 12, -1, -1, -1, -1, -1, -1, -1, -1,  // 40
+	 0,  1,  4,  5,  6,  8,  9, 10, 12, -1, -1, -1, -1, -1, -1, -1,  // 41
+	 0,  1,  2,  4,  5,  6,  8,  9, 10, 12, -1, -1, -1, -1, -1, -1,  // 42
+	 0,  1,  2,  3,  4,  5,  6,  8,  9, 10, 12, -1, -1, -1, -1, -1,  // 43
+	 0,  4,  5,  6,  7,  8,  9, 10, 12, -1, -1, -1, -1, -1, -1, -1,  // 44
+	 0,  1,  4,  5,  6,  7,  8,  9, 10, 12, -1, -1, -1, -1, -1, -1,  // 45
+	 0,  1,  2,  4,  5,  6,  7,  8,  9, 10, 12, -1, -1, -1, -1, -1,  // 46
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 12, -1, -1, -1, -1,  // 47
+	 0,  4,  8,  9, 10, 11, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 48
+	 0,  1,  4,  8,  9, 10, 11, 12, -1, -1, -1, -1, -1, -1, -1, -1,  // 49
+	 0,  1,  2,  4,  8,  9, 10, 11, 12, -1, -1, -1, -1, -1, -1, -1,  // 50
+	 0,  1,  2,  3,  4,  8,  9, 10, 11, 12, -1, -1, -1, -1, -1, -1,  // 51
+	 0,  4,  5,  8,  9, 10, 11, 12, -1, -1, -1, -1, -1, -1, -1, -1,  // 52
+	 0,  1,  4,  5,  8,  9, 10, 11, 12, -1, -1, -1, -1, -1, -1, -1,  // 53
+	 0,  1,  2,  4,  5,  8,  9, 10, 11, 12, -1, -1, -1, -1, -1, -1,  // 54
+	 0,  1,  2,  3,  4,  5,  8,  9, 10, 11, 12, -1, -1, -1, -1, -1,  // 55
+	 0,  4,  5,  6,  8,  9, 10, 11, 12, -1, -1, -1, -1, -1, -1, -1,  // 56
+	 0,  1,  4,  5,  6,  8,  9, 10, 11, 12, -1, -1, -1, -1, -1, -1,  // 57
+	 0,  1,  2,  4,  5,  6,  8,  9, 10, 11, 12, -1, -1, -1, -1, -1,  // 58
+	 0,  1,  2,  3,  4,  5,  6,  8,  9, 10, 11, 12, -1, -1, -1, -1,  // 59
+	 0,  4,  5,  6,  7,  8,  9, 10, 11, 12, -1, -1, -1, -1, -1, -1,  // 60
+	 0,  1,  4,  5,  6,  7,  8,  9, 10, 11, 12, -1, -1, -1, -1, -1,  // 61
+	 0,  1,  2,  4,  5,  6,  7,  8,  9, 10, 11, 12, -1, -1, -1, -1,  // 62
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, -1, -1, -1,  // 63
+	 0,  4,  8, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 64
+	 0,  1,  4,  8, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 65
+	 0,  1,  2,  4,  8, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 66
+	 0,  1,  2,  3,  4,  8, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,  // 67
+	 0,  4,  5,  8, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 68
+	 0,  1,  4,  5,  8, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 69
+	 0,  1,  2,  4,  5,  8, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,  // 70
+	 0,  1,  2,  3,  4,  5,  8, 12, 13, -1, -1, -1, -1, -1, -1, -1,  // 71
+	 0,  4,  5,  6,  8, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 72
+	 0,  1,  4,  5,  6,  8, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,  // 73
+	 0,  1,  2,  4,  5,  6,  8, 12, 13, -1, -1, -1, -1, -1, -1, -1,  // 74
+	 0,  1,  2,  3,  4,  5,  6,  8, 12, 13, -1, -1, -1, -1, -1, -1,  // 75
+	 0,  4,  5,  6,  7,  8, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,  // 76
+	 0,  1,  4,  5,  6,  7,  8, 12, 13, -1, -1, -1, -1, -1, -1, -1,  // 77
+	 0,  1,  2,  4,  5,  6,  7,  8, 12, 13, -1, -1, -1, -1, -1, -1,  // 78
+	 0,  1,  2,  3,  4,  5,  6,  7,  8, 12, 13, -1, -1, -1, -1, -1,  // 79
+	 0,  4,  8,  9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 80
+	 0,  1,  4,  8,  9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 81
+	 0,  1,  2,  4,  8,  9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,  // 82
+	 0,  1,  2,  3,  4,  8,  9, 12, 13, -1, -1, -1, -1, -1, -1, -1,  // 83
+	 0,  4,  5,  8,  9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 84
+	 0,  1,  4,  5,  8,  9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,  // 85
+	 0,  1,  2,  4,  5,  8,  9, 12, 13, -1, -1, -1, -1, -1, -1, -1,  // 86
+	 0,  1,  2,  3,  4,  5,  8,  9, 12, 13, -1, -1, -1, -1, -1, -1,  // 87
+	 0,  4,  5,  6,  8,  9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,  // 88
+	 0,  1,  4,  5,  6,  8,  9, 12, 13, -1, -1, -1, -1, -1, -1, -1,  // 89
+	 0,  1,  2,  4,  5,  6,  8,  9, 12, 13, -1, -1, -1, -1, -1, -1,  // 90
+	 0,  1,  2,  3,  4,  5,  6,  8,  9, 12, 13, -1, -1, -1, -1, -1,  // 91
+	 0,  4,  5,  6,  7,  8,  9, 12, 13, -1, -1, -1, -1, -1, -1, -1,  // 92
+	 0,  1,  4,  5,  6,  7,  8,  9, 12, 13, -1, -1, -1, -1, -1, -1,  // 93
+	 0,  1,  2,  4,  5,  6,  7,  8,  9, 12, 13, -1, -1, -1, -1, -1,  // 94
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 12, 13, -1, -1, -1, -1,  // 95
+	 0,  4,  8,  9, 10, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 96
+	 0,  1,  4,  8,  9, 10, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,  // 97
+	 0,  1,  2,  4,  8,  9, 10, 12, 13, -1, -1, -1, -1, -1, -1, -1,  // 98
+	 0,  1,  2,  3,  4,  8,  9, 10, 12, 13, -1, -1, -1, -1, -1, -1,  // 99
+	 0,  4,  5,  8,  9, 10, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,  // 100
+	 0,  1,  4,  5,  8,  9, 10, 12, 13, -1, -1, -1, -1, -1, -1, -1,  // 101
+	 0,  1,  2,  4,  5,  8,  9, 10, 12, 13, -1, -1, -1, -1, -1, -1,  // 102
+	 0,  1,  2,  3,  4,  5,  8,  9, 10, 12, 13, -1, -1, -1, -1, -1,  // 103
+	 0,  4,  5,  6,  8,  9, 10, 12, 13, -1, -1, -1, -1, -1, -1, -1,  // 104
+	 0,  1,  4,  5,  6,  8,  9, 10, 12, 13, -1, -1, -1, -1, -1, -1,  // 105
+	 0,  1,  2,  4,  5,  6,  8,  9, 10, 12, 13, -1, -1, -1, -1, -1,  // 106
+	 0,  1,  2,  3,  4,  5,  6,  8,  9, 10, 12, 13, -1, -1, -1, -1,  // 107
+	 0,  4,  5,  6,  7,  8,  9, 10, 12, 13, -1, -1, -1, -1, -1, -1,  // 108
+	 0,  1,  4,  5,  6,  7,  8,  9, 10, 12, 13, -1, -1, -1, -1, -1,  // 109
+	 0,  1,  2,  4,  5,  6,  7,  8,  9, 10, 12, 13, -1, -1, -1, -1,  // 110
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 12, 13, -1, -1, -1,  // 111
+	 0,  4,  8,  9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,  // 112
+	 0,  1,  4,  8,  9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1,  // 113
+	 0,  1,  2,  4,  8,  9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1,  // 114
+	 0,  1,  2,  3,  4,  8,  9, 10, 11, 12, 13, -1, -1, -1, -1, -1,  // 115
+	 0,  4,  5,  8,  9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1,  // 116
+	 0,  1,  4,  5,  8,  9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1,  // 117
+	 0,  1,  2,  4,  5,  8,  9, 10, 11, 12, 13, -1, -1, -1, -1, -1,  // 118
+	 0,  1,  2,  3,  4,  5,  8,  9, 10, 11, 12, 13, -1, -1, -1, -1,  // 119
+	 0,  4,  5,  6,  8,  9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1,  // 120
+	 0,  1,  4,  5,  6,  8,  9, 10, 11, 12, 13, -1, -1, -1, -1, -1,  // 121
+	 0,  1,  2,  4,  5,  6,  8,  9, 10, 11, 12, 13, -1, -1, -1, -1,  // 122
+	 0,  1,  2,  3,  4,  5,  6,  8,  9, 10, 11, 12, 13, -1, -1, -1,  // 123
+	 0,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, -1, -1, -1, -1, -1,  // 124
+	 0,  1,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, -1, -1, -1, -1,  // 125
+	 0,  1,  2,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, -1, -1, -1,  // 126
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, -1, -1,  // 127
+	 0,  4,  8, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 128
+	 0,  1,  4,  8, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 129
+	 0,  1,  2,  4,  8, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1, -1,  // 130
+	 0,  1,  2,  3,  4,  8, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1,  // 131
+	 0,  4,  5,  8, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 132
+	 0,  1,  4,  5,  8, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1, -1,  // 133
+	 0,  1,  2,  4,  5,  8, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1,  // 134
+	 0,  1,  2,  3,  4,  5,  8, 12, 13, 14, -1, -1, -1, -1, -1, -1,  // 135
+	 0,  4,  5,  6,  8, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1, -1,  // 136
+	 0,  1,  4,  5,  6,  8, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1,  // 137
+	 0,  1,  2,  4,  5,  6,  8, 12, 13, 14, -1, -1, -1, -1, -1, -1,  // 138
+	 0,  1,  2,  3,  4,  5,  6,  8, 12, 13, 14, -1, -1, -1, -1, -1,  // 139
+	 0,  4,  5,  6,  7,  8, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1,  // 140
+	 0,  1,  4,  5,  6,  7,  8, 12, 13, 14, -1, -1, -1, -1, -1, -1,  // 141
+	 0,  1,  2,  4,  5,  6,  7,  8, 12, 13, 14, -1, -1, -1, -1, -1,  // 142
+	 0,  1,  2,  3,  4,  5,  6,  7,  8, 12, 13, 14, -1, -1, -1, -1,  // 143
+	 0,  4,  8,  9, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 144
+	 0,  1,  4,  8,  9, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1, -1,  // 145
+	 0,  1,  2,  4,  8,  9, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1,  // 146
+	 0,  1,  2,  3,  4,  8,  9, 12, 13, 14, -1, -1, -1, -1, -1, -1,  // 147
+	 0,  4,  5,  8,  9, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1, -1,  // 148
+	 0,  1,  4,  5,  8,  9, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1,  // 149
+	 0,  1,  2,  4,  5,  8,  9, 12, 13, 14, -1, -1, -1, -1, -1, -1,  // 150
+	 0,  1,  2,  3,  4,  5,  8,  9, 12, 13, 14, -1, -1, -1, -1, -1,  // 151
+	 0,  4,  5,  6,  8,  9, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1,  // 152
+	 0,  1,  4,  5,  6,  8,  9, 12, 13, 14, -1, -1, -1, -1, -1, -1,  // 153
+	 0,  1,  2,  4,  5,  6,  8,  9, 12, 13, 14, -1, -1, -1, -1, -1,  // 154
+	 0,  1,  2,  3,  4,  5,  6,  8,  9, 12, 13, 14, -1, -1, -1, -1,  // 155
+	 0,  4,  5,  6,  7,  8,  9, 12, 13, 14, -1, -1, -1, -1, -1, -1,  // 156
+	 0,  1,  4,  5,  6,  7,  8,  9, 12, 13, 14, -1, -1, -1, -1, -1,  // 157
+	 0,  1,  2,  4,  5,  6,  7,  8,  9, 12, 13, 14, -1, -1, -1, -1,  // 158
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 12, 13, 14, -1, -1, -1,  // 159
+	 0,  4,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1, -1,  // 160
+	 0,  1,  4,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1,  // 161
+	 0,  1,  2,  4,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1, -1, -1,  // 162
+	 0,  1,  2,  3,  4,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1, -1,  // 163
+	 0,  4,  5,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1,  // 164
+	 0,  1,  4,  5,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1, -1, -1,  // 165
+	 0,  1,  2,  4,  5,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1, -1,  // 166
+	 0,  1,  2,  3,  4,  5,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1,  // 167
+	 0,  4,  5,  6,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1, -1, -1,  // 168
+	 0,  1,  4,  5,  6,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1, -1,  // 169
+	 0,  1,  2,  4,  5,  6,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1,  // 170
+	 0,  1,  2,  3,  4,  5,  6,  8,  9, 10, 12, 13, 14, -1, -1, -1,  // 171
+	 0,  4,  5,  6,  7,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1, -1,  // 172
+	 0,  1,  4,  5,  6,  7,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1,  // 173
+	 0,  1,  2,  4,  5,  6,  7,  8,  9, 10, 12, 13, 14, -1, -1, -1,  // 174
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 12, 13, 14, -1, -1,  // 175
+	 0,  4,  8,  9, 10, 11, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1,  // 176
+	 0,  1,  4,  8,  9, 10, 11, 12, 13, 14, -1, -1, -1, -1, -1, -1,  // 177
+	 0,  1,  2,  4,  8,  9, 10, 11, 12, 13, 14, -1, -1, -1, -1, -1,  // 178
+	 0,  1,  2,  3,  4,  8,  9, 10, 11, 12, 13, 14, -1, -1, -1, -1,  // 179
+	 0,  4,  5,  8,  9, 10, 11, 12, 13, 14, -1, -1, -1, -1, -1, -1,  // 180
+	 0,  1,  4,  5,  8,  9, 10, 11, 12, 13, 14, -1, -1, -1, -1, -1,  // 181
+	 0,  1,  2,  4,  5,  8,  9, 10, 11, 12, 13, 14, -1, -1, -1, -1,  // 182
+	 0,  1,  2,  3,  4,  5,  8,  9, 10, 11, 12, 13, 14, -1, -1, -1,  // 183
+	 0,  4,  5,  6,  8,  9, 10, 11, 12, 13, 14, -1, -1, -1, -1, -1,  // 184
+	 0,  1,  4,  5,  6,  8,  9, 10, 11, 12, 13, 14, -1, -1, -1, -1,  // 185
+	 0,  1,  2,  4,  5,  6,  8,  9, 10, 11, 12, 13, 14, -1, -1, -1,  // 186
+	 0,  1,  2,  3,  4,  5,  6,  8,  9, 10, 11, 12, 13, 14, -1, -1,  // 187
+	 0,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, -1, -1, -1, -1,  // 188
+	 0,  1,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, -1, -1, -1,  // 189
+	 0,  1,  2,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, -1, -1,  // 190
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, -1,  // 191
+	 0,  4,  8, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 192
+	 0,  1,  4,  8, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1,  // 193
+	 0,  1,  2,  4,  8, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1,  // 194
+	 0,  1,  2,  3,  4,  8, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1,  // 195
+	 0,  4,  5,  8, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1,  // 196
+	 0,  1,  4,  5,  8, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1,  // 197
+	 0,  1,  2,  4,  5,  8, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1,  // 198
+	 0,  1,  2,  3,  4,  5,  8, 12, 13, 14, 15, -1, -1, -1, -1, -1,  // 199
+	 0,  4,  5,  6,  8, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1,  // 200
+	 0,  1,  4,  5,  6,  8, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1,  // 201
+	 0,  1,  2,  4,  5,  6,  8, 12, 13, 14, 15, -1, -1, -1, -1, -1,  // 202
+	 0,  1,  2,  3,  4,  5,  6,  8, 12, 13, 14, 15, -1, -1, -1, -1,  // 203
+	 0,  4,  5,  6,  7,  8, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1,  // 204
+	 0,  1,  4,  5,  6,  7,  8, 12, 13, 14, 15, -1, -1, -1, -1, -1,  // 205
+	 0,  1,  2,  4,  5,  6,  7,  8, 12, 13, 14, 15, -1, -1, -1, -1,  // 206
+	 0,  1,  2,  3,  4,  5,  6,  7,  8, 12, 13, 14, 15, -1, -1, -1,  // 207
+	 0,  4,  8,  9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1,  // 208
+	 0,  1,  4,  8,  9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1,  // 209
+	 0,  1,  2,  4,  8,  9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1,  // 210
+	 0,  1,  2,  3,  4,  8,  9, 12, 13, 14, 15, -1, -1, -1, -1, -1,  // 211
+	 0,  4,  5,  8,  9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1,  // 212
+	 0,  1,  4,  5,  8,  9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1,  // 213
+	 0,  1,  2,  4,  5,  8,  9, 12, 13, 14, 15, -1, -1, -1, -1, -1,  // 214
+	 0,  1,  2,  3,  4,  5,  8,  9, 12, 13, 14, 15, -1, -1, -1, -1,  // 215
+	 0,  4,  5,  6,  8,  9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1,  // 216
+	 0,  1,  4,  5,  6,  8,  9, 12, 13, 14, 15, -1, -1, -1, -1, -1,  // 217
+	 0,  1,  2,  4,  5,  6,  8,  9, 12, 13, 14, 15, -1, -1, -1, -1,  // 218
+	 0,  1,  2,  3,  4,  5,  6,  8,  9, 12, 13, 14, 15, -1, -1, -1,  // 219
+	 0,  4,  5,  6,  7,  8,  9, 12, 13, 14, 15, -1, -1, -1, -1, -1,  // 220
+	 0,  1,  4,  5,  6,  7,  8,  9, 12, 13, 14, 15, -1, -1, -1, -1,  // 221
+	 0,  1,  2,  4,  5,  6,  7,  8,  9, 12, 13, 14, 15, -1, -1, -1,  // 222
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 12, 13, 14, 15, -1, -1,  // 223
+	 0,  4,  8,  9, 10, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1,  // 224
+	 0,  1,  4,  8,  9, 10, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1,  // 225
+	 0,  1,  2,  4,  8,  9, 10, 12, 13, 14, 15, -1, -1, -1, -1, -1,  // 226
+	 0,  1,  2,  3,  4,  8,  9, 10, 12, 13, 14, 15, -1, -1, -1, -1,  // 227
+	 0,  4,  5,  8,  9, 10, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1,  // 228
+	 0,  1,  4,  5,  8,  9, 10, 12, 13, 14, 15, -1, -1, -1, -1, -1,  // 229
+	 0,  1,  2,  4,  5,  8,  9, 10, 12, 13, 14, 15, -1, -1, -1, -1,  // 230
+	 0,  1,  2,  3,  4,  5,  8,  9, 10, 12, 13, 14, 15, -1, -1, -1,  // 231
+	 0,  4,  5,  6,  8,  9, 10, 12, 13, 14, 15, -1, -1, -1, -1, -1,  // 232
+	 0,  1,  4,  5,  6,  8,  9, 10, 12, 13, 14, 15, -1, -1, -1, -1,  // 233
+	 0,  1,  2,  4,  5,  6,  8,  9, 10, 12, 13, 14, 15, -1, -1, -1,  // 234
+	 0,  1,  2,  3,  4,  5,  6,  8,  9, 10, 12, 13, 14, 15, -1, -1,  // 235
+	 0,  4,  5,  6,  7,  8,  9, 10, 12, 13, 14, 15, -1, -1, -1, -1,  // 236
+	 0,  1,  4,  5,  6,  7,  8,  9, 10, 12, 13, 14, 15, -1, -1, -1,  // 237
+	 0,  1,  2,  4,  5,  6,  7,  8,  9, 10, 12, 13, 14, 15, -1, -1,  // 238
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 12, 13, 14, 15, -1,  // 239
+	 0,  4,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1,  // 240
+	 0,  1,  4,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1,  // 241
+	 0,  1,  2,  4,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1,  // 242
+	 0,  1,  2,  3,  4,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1, -1,  // 243
+	 0,  4,  5,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1,  // 244
+	 0,  1,  4,  5,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1,  // 245
+	 0,  1,  2,  4,  5,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1, -1,  // 246
+	 0,  1,  2,  3,  4,  5,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1,  // 247
+	 0,  4,  5,  6,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1,  // 248
+	 0,  1,  4,  5,  6,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1, -1,  // 249
+	 0,  1,  2,  4,  5,  6,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1,  // 250
+	 0,  1,  2,  3,  4,  5,  6,  8,  9, 10, 11, 12, 13, 14, 15, -1,  // 251
+	 0,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1, -1,  // 252
+	 0,  1,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1,  // 253
+	 0,  1,  2,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, -1,  // 254
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,  // 255
+};
+
+static const __m128i* encode_shuffle = (const __m128i*)encode_shuffle_rawbytes;
+
+// the total number of bytes of four lanes, indexed like encode_shuffle
+static const uint8_t encode_length[256] = {
+	 4,  5,  6,  7,  5,  6,  7,  8,  6,  7,  8,  9,  7,  8,  9, 10,
+	 5,  6,  7,  8,  6,  7,  8,  9,  7,  8,  9, 10,  8,  9, 10, 11,
+	 6,  7,  8,  9,  7,  8,  9, 10,  8,  9, 10, 11,  9, 10, 11, 12,
+	 7,  8,  9, 10,  8,  9, 10, 11,  9, 10, 11, 12, 10, 11, 12, 13,
+	 5,  6,  7,  8,  6,  7,  8,  9,  7,  8,  9, 10,  8,  9, 10, 11,
+	 6,  7,  8,  9,  7,  8,  9, 10,  8,  9, 10, 11,  9, 10, 11, 12,
+	 7,  8,  9, 10,  8,  9, 10, 11,  9, 10, 11, 12, 10, 11, 12, 13,
+	 8,  9, 10, 11,  9, 10, 11, 12, 10, 11, 12, 13, 11, 12, 13, 14,
+	 6,  7,  8,  9,  7,  8,  9, 10,  8,  9, 10, 11,  9, 10, 11, 12,
+	 7,  8,  9, 10,  8,  9, 10, 11,  9, 10, 11, 12, 10, 11, 12, 13,
+	 8,  9, 10, 11,  9, 10, 11, 12, 10, 11, 12, 13, 11, 12, 13, 14,
+	 9, 10, 11, 12, 10, 11, 12, 13, 11, 12, 13, 14, 12, 13, 14, 15,
+	 7,  8,  9, 10,  8,  9, 10, 11,  9, 10, 11, 12, 10, 11, 12, 13,
+	 8,  9, 10, 11,  9, 10, 11, 12, 10, 11, 12, 13, 11, 12, 13, 14,
+	 9, 10, 11, 12, 10, 11, 12, 13, 11, 12, 13, 14, 12, 13, 14, 15,
+	10, 11, 12, 13, 11, 12, 13, 14, 12, 13, 14, 15, 13, 14, 15, 16,
+};
+
+// spreads the 4 bits of a _mm_movemask_ps() result to 2 bits per lane
+static const uint8_t spread_lanes[16] = {
+	0x00, 0x01, 0x04, 0x05, 0x10, 0x11, 0x14, 0x15,
+	0x40, 0x41, 0x44, 0x45, 0x50, 0x51, 0x54, 0x55
+};
+
+static int write_int(uint8_t* out, uint32_t value) {
+	if (value < (1U << 7)) {
+		out[0] = value;
+		return 1;
+	}
+	if (value < (1U << 14)) {
+		out[0] = (value & 0x7F) | 0x80;
+		out[1] = value >> 7;
+		return 2;
+	}
+	if (value < (1U << 21)) {
+		out[0] = (value & 0x7F) | 0x80;
+		out[1] = ((value >> 7) & 0x7F) | 0x80;
+		out[2] = value >> 14;
+		return 3;
+	}
+	if (value < (1U << 28)) {
+		out[0] = (value & 0x7F) | 0x80;
+		out[1] = ((value >> 7) & 0x7F) | 0x80;
+		out[2] = ((value >> 14) & 0x7F) | 0x80;
+		out[3] = value >> 21;
+		return 4;
+	}
+	out[0] = (value & 0x7F) | 0x80;
+	out[1] = ((value >> 7) & 0x7F) | 0x80;
+	out[2] = ((value >> 14) & 0x7F) | 0x80;
+	out[3] = ((value >> 21) & 0x7F) | 0x80;
+	out[4] = value >> 28;
+	return 5;
+}
+
+static int write_int64(uint8_t* out, uint64_t value) {
+	int i;
+	for (i = 0; value >= 128; i++) {
+		out[i] = (value & 0x7F) | 0x80;
+		value >>= 7;
+	}
+	out[i] = value;
+	return i + 1;
+}
+
+// Encodes four 32-bit integers; always writes 16 bytes to out, even if
+// fewer bytes are used. Returns the number of bytes used.
+static inline int masked_vbyte_write_group(__m128i in, uint8_t* out) {
+	// integers with 5 bytes do not fit into a single vector
+	if (!_mm_testz_si128(in, _mm_set1_epi32(0xF0000000))) {
+		uint32_t values[4];
+		_mm_storeu_si128((__m128i *) values, in);
+		int consumed = write_int(out, values[0]);
+		consumed += write_int(out + consumed, values[1]);
+		consumed += write_int(out + consumed, values[2]);
+		consumed += write_int(out + consumed, values[3]);
+		return consumed;
+	}
+
+	// the lanes are < 2^28, therefore a signed comparison is fine
+	__m128i ge7 = _mm_cmpgt_epi32(in, _mm_set1_epi32((1 << 7) - 1));
+	__m128i ge14 = _mm_cmpgt_epi32(in, _mm_set1_epi32((1 << 14) - 1));
+	__m128i ge21 = _mm_cmpgt_epi32(in, _mm_set1_epi32((1 << 21) - 1));
+
+	// spread the 7-bit groups to the 4 bytes of each lane
+	__m128i byte0 = _mm_and_si128(in, _mm_set1_epi32(0x0000007F));
+	__m128i byte1 = _mm_and_si128(_mm_slli_epi32(in, 1),
+			_mm_set1_epi32(0x00007F00));
+	__m128i byte2 = _mm_and_si128(_mm_slli_epi32(in, 2),
+			_mm_set1_epi32(0x007F0000));
+	__m128i byte3 = _mm_and_si128(_mm_slli_epi32(in, 3),
+			_mm_set1_epi32(0x7F000000));
+	__m128i spread = _mm_or_si128(_mm_or_si128(byte0, byte1),
+			_mm_or_si128(byte2, byte3));
+
+	// set the continuation bits
+	__m128i cont = _mm_or_si128(
+			_mm_and_si128(ge7, _mm_set1_epi32(0x00000080)),
+			_mm_or_si128(_mm_and_si128(ge14, _mm_set1_epi32(0x00008000)),
+				_mm_and_si128(ge21, _mm_set1_epi32(0x00800000))));
+	spread = _mm_or_si128(spread, cont);
+
+	// squeeze out the unused bytes
+	uint32_t code = spread_lanes[_mm_movemask_ps(_mm_castsi128_ps(ge7))]
+			+ spread_lanes[_mm_movemask_ps(_mm_castsi128_ps(ge14))]
+			+ spread_lanes[_mm_movemask_ps(_mm_castsi128_ps(ge21))];
+	_mm_storeu_si128((__m128i *) out,
+			_mm_shuffle_epi8(spread, encode_shuffle[code]));
+	return encode_length[code];
+}
+
+// length : number of ints we want to encode
+// returns the number of written bytes
+static size_t masked_vbyte_encode(const uint32_t* in, uint8_t* out,
+		uint64_t length) {
+	uint8_t* initout = out;
+	uint64_t count = 0;
+
+	// each group writes 16 bytes; the unused bytes are overwritten by the
+	// following integers, which need at least 12 more bytes
+	for (; count + 16 <= length; count += 4) {
+		__m128i values = _mm_loadu_si128((const __m128i *) (in + count));
+		out += masked_vbyte_write_group(values, out);
+	}
+	for (; count < length; count++) {
+		out += write_int(out, in[count]);
+	}
+	return out - initout;
+}
+
+// length : number of ints we want to encode
+// returns the number of written bytes
+static size_t masked_vbyte_encode_delta(const uint32_t* in, uint8_t* out,
+		uint64_t length, uint32_t prev) {
+	uint8_t* initout = out;
+	uint64_t count = 0;
+	__m128i mprev = _mm_set1_epi32(prev);
+
+	// see masked_vbyte_encode
+	for (; count + 16 <= length; count += 4) {
+		__m128i values = _mm_loadu_si128((const __m128i *) (in + count));
+		// [P A B C]
+		__m128i shifted = _mm_alignr_epi8(values, mprev, 12);
+		out += masked_vbyte_write_group(_mm_sub_epi32(values, shifted), out);
+		mprev = values;
+	}
+	if (count > 0)
+		prev = in[count - 1];
+	for (; count < length; count++) {
+		out += write_int(out, in[count] - prev);
+		prev = in[count];
+	}
+	return out - initout;
+}
+
+// length : number of ints we want to encode
+// returns the number of written bytes
+static size_t masked_vbyte_encode_delta64(const uint64_t* in, uint8_t* out,
+		uint64_t length, uint64_t prev) {
+	uint8_t* initout = out;
+	uint64_t count = 0;
+	__m128i mprev = _mm_set1_epi64x((long long)prev);
+
+	// see masked_vbyte_encode
+	for (; count + 16 <= length; count += 4) {
+		__m128i values1 = _mm_loadu_si128((const __m128i *) (in + count));
+		__m128i values2 = _mm_loadu_si128((const __m128i *) (in + count + 2));
+		// [P A] and [B C]
+		__m128i delta1 = _mm_sub_epi64(values1,
+				_mm_alignr_epi8(values1, mprev, 8));
+		__m128i delta2 = _mm_sub_epi64(values2,
+				_mm_alignr_epi8(values2, values1, 8));
+		mprev = values2;
+
+		// deltas with more than 28 bits are encoded one by one
+		__m128i high_bits = _mm_set1_epi64x(0xFFFFFFFFF0000000LL);
+		if (!_mm_testz_si128(_mm_or_si128(delta1, delta2), high_bits)) {
+			uint64_t deltas[4];
+			_mm_storeu_si128((__m128i *) deltas, delta1);
+			_mm_storeu_si128((__m128i *) (deltas + 2), delta2);
+			out += write_int64(out, deltas[0]);
+			out += write_int64(out, deltas[1]);
+			out += write_int64(out, deltas[2]);
+			out += write_int64(out, deltas[3]);
+			continue;
+		}
+
+		// otherwise narrow them to 32-bit
+		__m128i deltas = _mm_castps_si128(_mm_shuffle_ps(
+					_mm_castsi128_ps(delta1), _mm_castsi128_ps(delta2),
+					_MM_SHUFFLE(2, 0, 2, 0)));
+		out += masked_vbyte_write_group(deltas, out);
+	}
+	if (count > 0)
+		prev = in[count - 1];
+	for (; count < length; count++) {
+		out += write_int64(out, in[count] - prev);
+		prev = in[count];
+	}
+	return out - initout;
+}
+
+static int size_int(uint32_t value) {
+	if (value < (1U << 7))
+		return 1;
+	if (value < (1U << 14))
+		return 2;
+	if (value < (1U << 21))
+		return 3;
+	if (value < (1U << 28))
+		return 4;
+	return 5;
+}
+
+static int size_int64(uint64_t value) {
+	int size = 1;
+	while (value >= 128) {
+		value >>= 7;
+		size++;
+	}
+	return size;
+}
+
+// returns -1 in each lane for every 7-bit threshold (2^7, 2^14, 2^21, 2^28)
+// that the lane is below; the encoded size is 5 plus this value
+static inline __m128i size_group(__m128i in) {
+	__m128i zero = _mm_setzero_si128();
+	__m128i lt7 = _mm_cmpeq_epi32(_mm_srli_epi32(in, 7), zero);
+	__m128i lt14 = _mm_cmpeq_epi32(_mm_srli_epi32(in, 14), zero);
+	__m128i lt21 = _mm_cmpeq_epi32(_mm_srli_epi32(in, 21), zero);
+	__m128i lt28 = _mm_cmpeq_epi32(_mm_srli_epi32(in, 28), zero);
+	return _mm_add_epi32(_mm_add_epi32(lt7, lt14), _mm_add_epi32(lt21, lt28));
+}
+
+// same as size_group, but for 64-bit lanes and 9 thresholds (2^7 to 2^63);
+// the encoded size is 10 plus this value
+static inline __m128i size_group64(__m128i in) {
+	__m128i zero = _mm_setzero_si128();
+	__m128i sum = zero;
+	int shift;
+	for (shift = 7; shift < 64; shift += 7)
+		sum = _mm_add_epi64(sum,
+				_mm_cmpeq_epi64(_mm_srli_epi64(in, shift), zero));
+	return sum;
+}
+
+static inline int64_t hsum_epi32(__m128i sum) {
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return (int32_t)_mm_cvtsi128_si32(sum);
+}
+
+static inline int64_t hsum_epi64(__m128i sum) {
+	return _mm_cvtsi128_si64(sum) + _mm_extract_epi64(sum, 1);
+}
+
+// the 32-bit lane sums are flushed after this many groups, before they
+// can overflow
+#define SIZE_FLUSH_GROUPS 65536
+
+// length : number of ints
+// returns the number of bytes required to encode them
+static size_t masked_vbyte_size(const uint32_t* in, uint64_t length) {
+	int64_t size = 5 * (int64_t)length;
+	uint64_t count = 0;
+
+	while (count + 4 <= length) {
+		__m128i sum = _mm_setzero_si128();
+		uint64_t groups;
+		for (groups = 0; groups < SIZE_FLUSH_GROUPS && count + 4 <= length;
+				groups++, count += 4) {
+			__m128i values = _mm_loadu_si128((const __m128i *) (in + count));
+			sum = _mm_add_epi32(sum, size_group(values));
+		}
+		size += hsum_epi32(sum);
+	}
+	for (; count < length; count++) {
+		size += size_int(in[count]) - 5;
+	}
+	return (size_t)size;
+}
+
+// length : number of ints
+// returns the number of bytes required to encode them with differential
+// coding, starting at prev
+static size_t masked_vbyte_size_delta(const uint32_t* in, uint64_t length,
+		uint32_t prev) {
+	int64_t size = 5 * (int64_t)length;
+	uint64_t count = 0;
+	__m128i mprev = _mm_set1_epi32(prev);
+
+	while (count + 4 <= length) {
+		__m128i sum = _mm_setzero_si128();
+		uint64_t groups;
+		for (groups = 0; groups < SIZE_FLUSH_GROUPS && count + 4 <= length;
+				groups++, count += 4) {
+			__m128i values = _mm_loadu_si128((const __m128i *) (in + count));
+			__m128i shifted = _mm_alignr_epi8(values, mprev, 12);
+			sum = _mm_add_epi32(sum,
+					size_group(_mm_sub_epi32(values, shifted)));
+			mprev = values;
+		}
+		size += hsum_epi32(sum);
+	}
+	if (count > 0)
+		prev = in[count - 1];
+	for (; count < length; count++) {
+		size += size_int(in[count] - prev) - 5;
+		prev = in[count];
+	}
+	return (size_t)size;
+}
+
+// length : number of ints
+// returns the number of bytes required to encode them
+static size_t masked_vbyte_size64(const uint64_t* in, uint64_t length) {
+	int64_t size = 10 * (int64_t)length;
+	uint64_t count = 0;
+	__m128i sum = _mm_setzero_si128();
+
+	for (; count + 2 <= length; count += 2) {
+		__m128i values = _mm_loadu_si128((const __m128i *) (in + count));
+		sum = _mm_add_epi64(sum, size_group64(values));
+	}
+	size += hsum_epi64(sum);
+	for (; count < length; count++) {
+		size += size_int64(in[count]) - 10;
+	}
+	return (size_t)size;
+}
+
+// length : number of ints
+// returns the number of bytes required to encode them with differential
+// coding, starting at prev
+static size_t masked_vbyte_size_delta64(const uint64_t* in, uint64_t length,
+		uint64_t prev) {
+	int64_t size = 10 * (int64_t)length;
+	uint64_t count = 0;
+	__m128i mprev = _mm_set1_epi64x((long long)prev);
+	__m128i sum = _mm_setzero_si128();
+
+	for (; count + 2 <= length; count += 2) {
+		__m128i values = _mm_loadu_si128((const __m128i *) (in + count));
+		__m128i shifted = _mm_alignr_epi8(values, mprev, 8);
+		sum = _mm_add_epi64(sum, size_group64(_mm_sub_epi64(values, shifted)));
+		mprev = values;
+	}
+	size += hsum_epi64(sum);
+	if (count > 0)
+		prev = in[count - 1];
+	for (; count < length; count++) {
+		size += size_int64(in[count] - prev) - 10;
+		prev = in[count];
+	}
+	return (size_t)size;
+}
+
+const masked_vbyte_encode_kernels MASKEDVBYTE_CONCAT(masked_vbyte_encode_kernels, MASKEDVBYTE_ISA) = {
+    masked_vbyte_encode,
+    masked_vbyte_encode_delta,
+    masked_vbyte_encode_delta64,
+    masked_vbyte_size,
+    masked_vbyte_size_delta,
+    masked_vbyte_size64,
+    masked_vbyte_size_delta64
+};
@@ -0,0 +1,45 @@
+
+#ifndef VARINTENCODE_H_
+#define VARINTENCODE_H_
+#include <stdint.h>// please use a C99-compatible compiler
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// varintencode.c is compiled once per instruction set (SSE4.1, AVX and AVX2),
+// just like varintdecode.c.
+typedef struct masked_vbyte_encode_kernels {
+	// Write "length" 32-bit integers in varint format to out. Returns the number of bytes written.
+	size_t (*encode)(const uint32_t* in, uint8_t* out, uint64_t length);
+
+	// Write "length" 32-bit integers in varint format to out, with differential coding starting at prev. Returns the number of bytes written.
+	size_t (*encode_delta)(const uint32_t* in, uint8_t* out, uint64_t length, uint32_t prev);
+
+	// Write "length" 64-bit integers in varint format to out, with differential coding starting at prev. Returns the number of bytes written.
+	size_t (*encode_delta64)(const uint64_t* in, uint8_t* out, uint64_t length, uint64_t prev);
+
+	// Returns the number of bytes required to write "length" 32-bit integers in varint format.
+	size_t (*size)(const uint32_t* in, uint64_t length);
+
+	// Returns the number of bytes required to write "length" 32-bit integers in varint format, with differential coding starting at prev.
+	size_t (*size_delta)(const uint32_t* in, uint64_t length, uint32_t prev);
+
+	// Returns the number of bytes required to write "length" 64-bit integers in varint format.
+	size_t (*size64)(const uint64_t* in, uint64_t length);
+
+	// Returns the number of bytes required to write "length" 64-bit integers in varint format, with differential coding starting at prev.
+	size_t (*size_delta64)(const uint64_t* in, uint64_t length, uint64_t prev);
+} masked_vbyte_encode_kernels;
+
+// The kernels compiled with -msse4.1, -mavx and -mavx2
+extern const masked_vbyte_encode_kernels masked_vbyte_encode_kernels_sse41;
+extern const masked_vbyte_encode_kernels masked_vbyte_encode_kernels_avx;
+extern const masked_vbyte_encode_kernels masked_vbyte_encode_kernels_avx2;
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* VARINTENCODE_H_ */
@@ -24,68 +24,129 @@ typedef signed char int8_t;
 #  include <stdint.h>
 #endif
 
-#if defined(__AVX__) || defined(__AVX2__) || defined(__SSE4__)
-#  define USE_MASKEDVBYTE 1
-#endif
+#include <algorithm>
 
 #include "vbyte.h"
 #include "varintdecode.h"
+#include "varintencode.h"
 
 namespace vbyte {
 
-#ifdef __SSE2__
+#if defined(USE_MASKEDVBYTE)
 
-// AVX might be enabled at compile time, but it's still possible that
-// it's not available at run-time because the CPU is an older model.
+// The MaskedVbyte kernels are compiled for SSE4.1, AVX and AVX2. Which one
+// can be used is only known at run-time, because the CPU might be an
+// older model.
 
 // from http://stackoverflow.com/questions/6121792/how-to-check-if-a-cpu-supports-the-sse3-instruction-set
 
 #ifdef _WIN32
 //  Windows
 #  include <intrin.h>
-#  define cpuid    __cpuid
+#  define cpuid(info, type, subtype)   __cpuidex(info, type, subtype)
+#  define xgetbv()                     _xgetbv(0)
 #else
 //  GCC Inline Assembly
 static void
-cpuid(int cpuinfo[4], int infotype) {
+cpuid(int cpuinfo[4], int infotype, int subtype) {
   __asm__ __volatile__ (
       "cpuid":
       "=a" (cpuinfo[0]),
       "=b" (cpuinfo[1]),
       "=c" (cpuinfo[2]),
       "=d" (cpuinfo[3]) :
-      "a" (infotype)
+      "a" (infotype),
+      "c" (subtype)
+  );
+}
+
+static uint64_t
+xgetbv() {
+  uint32_t eax, edx;
+  __asm__ __volatile__ (
+      "xgetbv":
+      "=a" (eax),
+      "=d" (edx) :
+      "c" (0)
   );
+  return ((uint64_t)edx << 32) | eax;
 }
 #endif
 
-static inline bool
-is_avx_available()
-{
-  static bool available = false;
-  static bool initialized = false;
-  if (!initialized) {
-    initialized = true;
+enum {
+  kScalar = 0,
+  kSse41,
+  kAvx,
+  kAvx2
+};
 
-    int info[4];
-    cpuid(info, 0);
-    int num_ids = info[0];
-    cpuid(info, 0x80000000);
+static int
+select_instruction_set()
+{
+  int info[4];
+  cpuid(info, 0, 0);
+  int num_ids = info[0];
+  if (num_ids < 1)
+    return kScalar;
 
-    //  Detect Instruction Set
-    if (num_ids >= 1) {
-      cpuid(info, 0x00000001);
-      available = (info[2] & ((int)1 << 28)) != 0;
-    }
+  //  Detect Instruction Set
+  cpuid(info, 0x00000001, 0);
+  bool sse41 = (info[2] & ((int)1 << 19)) != 0;
+  // AVX also requires that the OS saves the YMM registers (OSXSAVE, XCR0)
+  bool avx = (info[2] & ((int)1 << 28)) != 0
+                && (info[2] & ((int)1 << 27)) != 0
+                && (xgetbv() & 6) == 6;
+  bool avx2 = false;
+  if (avx && num_ids >= 7) {
+    cpuid(info, 0x00000007, 0);
+    avx2 = (info[1] & ((int)1 << 5)) != 0;
   }
 
-  return available;
+  if (avx2)
+    return kAvx2;
+  if (avx)
+    return kAvx;
+  if (sse41)
+    return kSse41;
+  return kScalar;
 }
-#else
-static inline bool
-is_avx_available()
+
+// Returns the best instruction set of this CPU. The CPU is queried on
+// first use; the initialization of the static variable is thread-safe
+// (C++11).
+static inline int
+instruction_set()
+{
+  static const int isa = select_instruction_set();
+  return isa;
+}
+
+// Returns the best MaskedVbyte decoding kernels for this CPU, or NULL if
+// SSE4.1 is not available.
+static inline const masked_vbyte_kernels *
+masked_vbyte()
+{
+  static const masked_vbyte_kernels *kernels[] = {
+    0,
+    &masked_vbyte_kernels_sse41,
+    &masked_vbyte_kernels_avx,
+    &masked_vbyte_kernels_avx2
+  };
+  return kernels[instruction_set()];
+}
+
+// Returns the best encoding kernels for this CPU, or NULL if SSE4.1 is not
+// available.
+static inline const masked_vbyte_encode_kernels *
+masked_vbyte_encode()
 {
-  return false;
+  static const masked_vbyte_encode_kernels *kernels[] = {
+    0,
+    &masked_vbyte_encode_kernels_sse41,
+    &masked_vbyte_encode_kernels_avx,
+    &masked_vbyte_encode_kernels_avx2
+  };
+  return kernels[instruction_set()];
 }
 #endif
 
@@ -401,6 +462,94 @@ compress_unsorted(const T *in, uint8_t *out, size_t length)
   return out - initial_out;
 }
 
+// Compresses |length| integers, with delta encoding if |previous| is not
+// NULL. Used by compress_bounded.
+static inline size_t
+compress_block(const uint32_t *in, uint8_t *out, size_t length,
+                const uint32_t *previous)
+{
+  return previous
+          ? vbyte_compress_sorted32(in, out, *previous, length)
+          : vbyte_compress_unsorted32(in, out, length);
+}
+
+static inline size_t
+compress_block(const uint64_t *in, uint8_t *out, size_t length,
+                const uint64_t *previous)
+{
+  return previous
+          ? vbyte_compress_sorted64(in, out, *previous, length)
+          : vbyte_compress_unsorted64(in, out, length);
+}
+
+static inline size_t
+compressed_size_block(const uint32_t *in, size_t length,
+                const uint32_t *previous)
+{
+  return previous
+          ? vbyte_compressed_size_sorted32(in, length, *previous)
+          : vbyte_compressed_size_unsorted32(in, length);
+}
+
+static inline size_t
+compressed_size_block(const uint64_t *in, size_t length,
+                const uint64_t *previous)
+{
+  return previous
+          ? vbyte_compressed_size_sorted64(in, length, *previous)
+          : vbyte_compressed_size_unsorted64(in, length);
+}
+
+// Compresses as many integers as fit into |capacity| bytes. As long as
+// there is room for at least 16 integers in the worst case, all integers
+// which are guaranteed to fit are compressed with a single call. Only the
+// final stretch is measured first, and compressed one integer at a time if
+// it does not fit as a whole.
+template<typename T>
+static inline size_t
+compress_bounded(const T *in, size_t length, uint8_t *out, size_t capacity,
+                T *previous, size_t *consumed)
+{
+  const size_t kMaxSize = sizeof(T) + sizeof(T) / 4; // 5 or 10 bytes
+  size_t i = 0;
+  size_t size = 0;
+
+  for (;;) {
+    size_t n = (capacity - size) / kMaxSize;
+    if (n > length - i)
+      n = length - i;
+    if (n < 16)
+      break;
+    size += compress_block(in + i, out + size, n, previous);
+    i += n;
+    if (previous)
+      *previous = in[i - 1];
+  }
+
+  // every integer needs at least one byte
+  size_t n = length - i;
+  if (n > capacity - size)
+    n = capacity - size;
+  if (n > 0 && compressed_size_block(in + i, n, previous) <= capacity - size) {
+    size += compress_block(in + i, out + size, n, previous);
+    i += n;
+    if (previous)
+      *previous = in[i - 1];
+  }
+
+  for (; i < length; i++) {
+    T value = previous ? in[i] - *previous : in[i];
+    if ((size_t)compressed_size(value) > capacity - size)
+      break;
+    size += write_int(out + size, value);
+    if (previous)
+      *previous = in[i];
+  }
+
+  *consumed = i;
+  return size;
+}
+
 template<typename T>
 static inline size_t
 uncompress_unsorted(const uint8_t *in, T *out, size_t length)
@@ -445,6 +594,34 @@ uncompress_sorted(const uint8_t *in, T *out, T previous, size_t length)
   return in - initial_in;
 }
 
+template<typename T>
+static inline size_t
+uncompress_unsorted_bytes(const uint8_t *in, size_t size, T *out)
+{
+  const uint8_t *end = in + size;
+  const T *initout = out;
+
+  while (in < end)
+    in += read_int(in, out++);
+  return out - initout;
+}
+
+template<typename T>
+static inline size_t
+uncompress_sorted_bytes(const uint8_t *in, size_t size, T *out, T previous)
+{
+  const uint8_t *end = in + size;
+  const T *initout = out;
+
+  while (in < end) {
+    T current;
+    in += read_int(in, &current);
+    previous += current;
+    *out++ = previous;
+  }
+  return out - initout;
+}
+
 template<typename T>
 static inline T
 select_sorted(const uint8_t *in, T previous, size_t index)
@@ -457,6 +634,54 @@ select_sorted(const uint8_t *in, T previous, size_t index)
   return previous;
 }
 
+// Adds the first |count| deltas of |in| to |*previous|. The deltas are
+// decoded as unsorted integers and then summed, which is cheaper than
+// computing the prefix sum of every integer. Returns the number of bytes
+// that were read.
+template<typename T>
+static inline size_t
+skip_sorted(const uint8_t *in, size_t count, T *previous,
+                size_t (*uncompress)(const uint8_t *, T *, size_t))
+{
+  T buffer[256];
+  T sum = 0;
+  size_t consumed = 0;
+
+  while (count > 0) {
+    size_t n = count < 256 ? count : 256;
+    consumed += uncompress(in + consumed, buffer, n);
+    for (size_t i = 0; i < n; i++)
+      sum += buffer[i];
+    count -= n;
+  }
+  *previous += sum;
+  return consumed;
+}
+
+template<typename T, typename Sample>
+static inline size_t
+build_index_sorted(const uint8_t *in, size_t length, T previous,
+                size_t interval, Sample *samples,
+                size_t (*uncompress)(const uint8_t *, T *, size_t))
+{
+  assert(interval > 0);
+
+  // the deltas between two samples are summed up with the (vectorized)
+  // decoder, which also yields the byte offsets
+  size_t offset = 0;
+  size_t count = 0;
+
+  for (size_t i = 0; i < length; i += interval) {
+    samples[count].offset = offset;
+    samples[count].previous = previous;
+    count++;
+    if (length - i <= interval)
+      break;
+    offset += skip_sorted(in + offset, interval, &previous, uncompress);
+  }
+  return count;
+}
+
 template<typename T>
 static inline T
 select_unsorted(const uint8_t *in, size_t index)
@@ -468,6 +693,37 @@ select_unsorted(const uint8_t *in, size_t index)
   return value;
 }
 
+template<typename T>
+static inline void
+select_many_sorted(const uint8_t *in, T previous, const size_t *indices,
+                size_t count, T *out)
+{
+  size_t k = 0;
+
+  for (size_t i = 0; k < count; i++) {
+    T current;
+    in += read_int(in, &current);
+    previous += current;
+    for (; k < count && indices[k] == i; k++)
+      out[k] = previous;
+  }
+}
+
+template<typename T>
+static inline void
+select_many_unsorted(const uint8_t *in, const size_t *indices, size_t count,
+                T *out)
+{
+  size_t k = 0;
+
+  for (size_t i = 0; k < count; i++) {
+    T value;
+    in += read_int(in, &value);
+    for (; k < count && indices[k] == i; k++)
+      out[k] = value;
+  }
+}
+
 template<typename T>
 static inline size_t
 search_unsorted(const uint8_t *in, size_t length, T value)
@@ -496,180 +752,1692 @@ sorted_search(const uint8_t *in, size_t length, T value, T previous, T *actual)
       return i;
     }
   }
+  *actual = previous;
   return length;
 }
 
-} // namespace vbyte
-
-size_t
-vbyte_compressed_size_sorted32(const uint32_t *in, size_t length,
-                uint32_t previous)
+static inline size_t
+count(const uint8_t *in, size_t size)
 {
-  return vbyte::compressed_size_sorted(in, length, previous);
-}
+  size_t count = 0;
 
-size_t
-vbyte_compressed_size_sorted64(const uint64_t *in, size_t length,
-                uint64_t previous)
-{
-  return vbyte::compressed_size_sorted(in, length, previous);
+  for (size_t i = 0; i < size; i++)
+    count += (in[i] & 0x80) == 0;
+  return count;
 }
 
-size_t
-vbyte_compressed_size_unsorted32(const uint32_t *in, size_t length)
+static inline size_t
+locate(const uint8_t *in, size_t size, size_t index)
 {
-  return vbyte::compressed_size_unsorted(in, length);
-}
+  if (index == 0)
+    return 0;
 
-size_t
-vbyte_compressed_size_unsorted64(const uint64_t *in, size_t length)
-{
-  return vbyte::compressed_size_unsorted(in, length);
+  for (size_t i = 0; i < size; i++) {
+    if ((in[i] & 0x80) == 0 && --index == 0)
+      return i + 1;
+  }
+  return size;
 }
 
-size_t
-vbyte_compress_unsorted32(const uint32_t *in, uint8_t *out, size_t length)
+// Returns the byte offset of the |count|th integer, counted backwards from
+// the end of the |size| bytes at |in|; the last integer has |count| 1.
+static inline size_t
+locate_backward(const uint8_t *in, size_t size, size_t count)
 {
-  return vbyte::compress_unsorted(in, out, length);
+  // an integer starts right after the terminating byte of its predecessor
+  for (size_t i = size; i > 0; i--) {
+    if ((in[i - 1] & 0x80) == 0 && count-- == 0)
+      return i;
+  }
+  return 0;
 }
 
-size_t
-vbyte_compress_unsorted64(const uint64_t *in, uint8_t *out, size_t length)
+template<typename T>
+static inline size_t
+uncompress_reverse_unsorted(const uint8_t *in, size_t size, T *out,
+                size_t length,
+                size_t (*uncompress)(const uint8_t *, T *, size_t))
 {
-  return vbyte::compress_unsorted(in, out, length);
+  size_t offset = locate_backward(in, size, length);
+  uncompress(in + offset, out, length);
+  std::reverse(out, out + length);
+  return offset;
 }
 
-size_t
-vbyte_uncompress_unsorted32(const uint8_t *in, uint32_t *out, size_t length)
+// Replaces the |old_bytes| bytes at |in| + |offset| with the |new_bytes|
+// bytes in |buffer|, and moves the tail of the sequence. Returns the new size.
+static inline size_t
+replace_bytes(uint8_t *in, size_t size, size_t offset, size_t old_bytes,
+                const uint8_t *buffer, size_t new_bytes)
 {
-#if defined(USE_MASKEDVBYTE)
-  if (vbyte::is_avx_available())
-    return masked_vbyte_decode(in, out, (uint64_t)length);
-#endif
-  return vbyte::uncompress_unsorted(in, out, length);
+  memmove(in + offset + new_bytes, in + offset + old_bytes,
+                  size - offset - old_bytes);
+  memcpy(in + offset, buffer, new_bytes);
+  return size - old_bytes + new_bytes;
 }
 
-size_t
-vbyte_uncompress_unsorted64(const uint8_t *in, uint64_t *out, size_t length)
+// The delta of the integer following |value| is split into two deltas;
+// nothing else has to be re-encoded.
+template<typename T>
+static inline size_t
+insert_sorted(uint8_t *in, size_t length, size_t size, T previous, T value,
+                size_t (*search)(const uint8_t *, size_t, T, T, T *))
 {
-  return vbyte::uncompress_unsorted(in, out, length);
+  assert(value >= previous);
+
+  // if |value| is greater than all integers then |actual| is the last one
+  T actual;
+  size_t index = search(in, length, value, previous, &actual);
+  if (index == length)
+    return size + write_int(in + size, value - actual);
+  assert(actual != value);
+
+  size_t offset = vbyte_locate(in, size, index);
+  T delta;
+  size_t old_bytes = read_int(in + offset, &delta);
+  uint8_t buffer[2 * (sizeof(T) + sizeof(T) / 4)];
+  size_t new_bytes = write_int(buffer, value - (actual - delta));
+  new_bytes += write_int(buffer + new_bytes, actual - value);
+  return replace_bytes(in, size, offset, old_bytes, buffer, new_bytes);
 }
 
-size_t
-vbyte_compress_sorted32(const uint32_t *in, uint8_t *out, uint32_t previous,
-                size_t length)
+// The delta of |value| is added to the delta of the following integer.
+template<typename T>
+static inline size_t
+erase_sorted(uint8_t *in, size_t length, size_t size, T previous, T value,
+                size_t (*search)(const uint8_t *, size_t, T, T, T *))
 {
-  return vbyte::compress_sorted(in, out, previous, length);
+  T actual;
+  size_t index = search(in, length, value, previous, &actual);
+  if (index == length || actual != value)
+    return size;
+
+  size_t offset = vbyte_locate(in, size, index);
+  if (index + 1 == length)
+    return offset;
+
+  T delta, next;
+  size_t old_bytes = read_int(in + offset, &delta);
+  old_bytes += read_int(in + offset + old_bytes, &next);
+  uint8_t buffer[sizeof(T) + sizeof(T) / 4];
+  size_t new_bytes = write_int(buffer, delta + next);
+  return replace_bytes(in, size, offset, old_bytes, buffer, new_bytes);
 }
 
-size_t
-vbyte_compress_sorted64(const uint64_t *in, uint8_t *out, uint64_t previous,
-                size_t length)
+// the split point is the first integer which starts at or after size / 2
+static inline size_t
+split_offset(const uint8_t *in, size_t size)
 {
-  return vbyte::compress_sorted(in, out, previous, length);
+  size_t offset = size / 2;
+  while (offset > 0 && offset < size && (in[offset - 1] & 0x80))
+    offset++;
+  return offset;
 }
 
-size_t
-vbyte_uncompress_sorted32(const uint8_t *in, uint32_t *out, uint32_t previous,
-                size_t length)
+// The left part is copied. |previous|, the last value of the left part,
+// turns the first delta of the right part into an absolute value; the rest
+// of the right part is copied, too.
+template<typename T>
+static inline void
+split_at(const uint8_t *in, size_t size, size_t offset, T previous,
+                uint8_t *left, size_t *left_size, uint8_t *right,
+                size_t *right_size)
 {
-#if defined(USE_MASKEDVBYTE)
-  if (vbyte::is_avx_available())
-    return masked_vbyte_decode_delta(in, out, (uint64_t)length, previous);
-#endif
-  return vbyte::uncompress_sorted(in, out, previous, length);
+  *right_size = 0;
+  if (offset < size) {
+    T delta;
+    size_t bytes = read_int(in + offset, &delta);
+    *right_size = write_int(right, previous + delta);
+    memcpy(right + *right_size, in + offset + bytes, size - offset - bytes);
+    *right_size += size - offset - bytes;
+  }
+
+  memmove(left, in, offset);
+  *left_size = offset;
 }
 
-size_t
-vbyte_uncompress_sorted64(const uint8_t *in, uint64_t *out, uint64_t previous,
-                size_t length)
+// The deltas of the left part are summed up to find its last value.
+template<typename T>
+static inline size_t
+split_sorted(const uint8_t *in, size_t size, T previous, uint8_t *left,
+                size_t *left_size, uint8_t *right, size_t *right_size,
+                size_t (*uncompress)(const uint8_t *, T *, size_t))
 {
-  return vbyte::uncompress_sorted(in, out, previous, length);
+  size_t offset = split_offset(in, size);
+  size_t count = vbyte_count(in, offset);
+  skip_sorted(in, count, &previous, uncompress);
+  split_at(in, size, offset, previous, left, left_size, right, right_size);
+  return count;
 }
 
-uint32_t
-vbyte_select_sorted32(const uint8_t *in, size_t size, uint32_t previous,
-                size_t index)
+// Only the deltas between the last sample in front of the split point and
+// the split point are summed up.
+template<typename T, typename Sample>
+static inline size_t
+split_sorted_indexed(const uint8_t *in, size_t size, size_t length,
+                const Sample *samples, size_t interval, uint8_t *left,
+                size_t *left_size, uint8_t *right, size_t *right_size,
+                size_t (*uncompress)(const uint8_t *, T *, size_t))
 {
-  (void)size;
-#if defined(USE_MASKEDVBYTE)
-  if (vbyte::is_avx_available())
-    return masked_vbyte_select_delta(in, (uint64_t)size, previous, index);
-#endif
-  return vbyte::select_sorted<uint32_t>(in, previous, index);
+  if (length == 0) {
+    *left_size = *right_size = 0;
+    return 0;
+  }
+
+  size_t offset = split_offset(in, size);
+  size_t low = 0;
+  size_t high = (length + interval - 1) / interval;
+  while (low + 1 < high) {
+    size_t middle = low + (high - low) / 2;
+    if (samples[middle].offset <= offset)
+      low = middle;
+    else
+      high = middle;
+  }
+
+  const Sample *sample = &samples[low];
+  T previous = sample->previous;
+  size_t count = vbyte_count(in + sample->offset, offset - sample->offset);
+  skip_sorted(in + sample->offset, count, &previous, uncompress);
+  split_at(in, size, offset, previous, left, left_size, right, right_size);
+  return low * interval + count;
 }
 
-uint64_t
-vbyte_select_sorted64(const uint8_t *in, size_t size, uint64_t previous,
-                size_t index)
+// The first delta of |in2| is rebased to |last|, the last value of |in1|;
+// everything else is copied.
+template<typename T>
+static inline size_t
+concat_sorted(const uint8_t *in1, size_t size1, T last, const uint8_t *in2,
+                size_t size2, T previous, uint8_t *out)
 {
-  (void)size;
-  return vbyte::select_sorted<uint64_t>(in, previous, index);
+  memmove(out, in1, size1);
+  if (size2 == 0)
+    return size1;
+
+  T delta;
+  size_t bytes = read_int(in2, &delta);
+  assert(previous + delta >= last);
+  size_t size = size1 + write_int(out + size1, previous + delta - last);
+  memcpy(out + size, in2 + bytes, size2 - bytes);
+  return size + size2 - bytes;
 }
 
-uint32_t
-vbyte_select_unsorted32(const uint8_t *in, size_t size, size_t index)
+template<typename T>
+static inline void
+sorted_search_many(const uint8_t *in, size_t length, T previous,
+                const T *values, size_t count, size_t *positions, T *actual)
 {
-  (void)size;
-  return vbyte::select_unsorted<uint32_t>(in, index);
+  size_t k = 0;
+
+  for (size_t i = 0; k < count && i < length; i++) {
+    T v;
+    in += read_int(in, &v);
+    previous += v;
+    for (; k < count && values[k] <= previous; k++) {
+      positions[k] = i;
+      actual[k] = previous;
+    }
+  }
+  for (; k < count; k++)
+    positions[k] = length;
 }
 
-uint64_t
-vbyte_select_unsorted64(const uint8_t *in, size_t size, size_t index)
+// returns the sample whose block contains the lower bound of |value|
+template<typename T, typename Sample>
+static inline const Sample *
+find_sample(const Sample *samples, size_t count, T value)
 {
-  (void)size;
-  return vbyte::select_unsorted<uint64_t>(in, index);
+  // find the first sample which does not compare less than |value|; the
+  // lower bound is then in the block in front of it
+  size_t low = 0;
+  size_t high = count;
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    if (samples[middle].previous < value)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return &samples[low > 0 ? low - 1 : 0];
 }
 
-size_t
-vbyte_search_unsorted32(const uint8_t *in, size_t length, uint32_t value)
+template<typename T, typename Sample>
+static inline size_t
+search_lower_bound_indexed(const uint8_t *in, size_t length,
+                const Sample *samples, size_t interval, T value, T *actual,
+                size_t (*search)(const uint8_t *, size_t, T, T, T *))
 {
-  return vbyte::search_unsorted(in, length, value);
+  if (length == 0)
+    return 0;
+
+  const Sample *sample = find_sample(samples,
+                  (length + interval - 1) / interval, value);
+  size_t first = (sample - samples) * interval;
+  size_t remaining = length - first < interval ? length - first : interval;
+  return first + search(in + sample->offset, remaining, value,
+                  sample->previous, actual);
 }
 
-size_t
-vbyte_search_unsorted64(const uint8_t *in, size_t length, uint64_t value)
+// Decodes the next group of (up to) 16 integers of a sequence with
+// |remaining| integers left; stores the number of integers in |*count| and
+// returns the number of bytes read. The MaskedVbyte group decoder loads
+// 16 bytes, which exist if at least 16 integers are left.
+static inline size_t
+decode_group_sorted32(const uint8_t *in, uint32_t *out, uint32_t *previous,
+                size_t remaining, size_t *count)
 {
-  return vbyte::search_unsorted(in, length, value);
+#if defined(USE_MASKEDVBYTE)
+  if (remaining >= 16) {
+    if (const masked_vbyte_kernels *simd = masked_vbyte()) {
+      uint64_t ints_read;
+      size_t bytes = simd->decode_group_delta(in, out, previous, &ints_read);
+      *count = ints_read;
+      return bytes;
+    }
+  }
+#endif
+  *count = remaining < 16 ? remaining : 16;
+  size_t bytes = uncompress_sorted(in, out, *previous, *count);
+  *previous = out[*count - 1];
+  return bytes;
 }
 
-size_t
-vbyte_search_lower_bound_sorted32(const uint8_t *in, size_t length,
-                uint32_t value, uint32_t previous, uint32_t *actual)
+static inline size_t
+decode_group_sorted64(const uint8_t *in, uint64_t *out, uint64_t *previous,
+                size_t remaining, size_t *count)
 {
 #if defined(USE_MASKEDVBYTE)
-  if (vbyte::is_avx_available())
-    return (size_t)masked_vbyte_search_delta(in, (uint64_t)length, previous,
-                  value, actual);
+  if (remaining >= 16) {
+    if (const masked_vbyte_kernels *simd = masked_vbyte()) {
+      uint64_t ints_read;
+      size_t bytes = simd->decode_group_delta64(in, out, previous,
+                      &ints_read);
+      *count = ints_read;
+      return bytes;
+    }
+  }
 #endif
-  return vbyte::sorted_search(in, length, value, previous, actual);
+  *count = remaining < 16 ? remaining : 16;
+  size_t bytes = uncompress_sorted(in, out, *previous, *count);
+  *previous = out[*count - 1];
+  return bytes;
 }
 
-size_t
-vbyte_search_lower_bound_sorted64(const uint8_t *in, size_t length,
-                uint64_t value, uint64_t previous, uint64_t *actual)
+// decodes the next group of integers into the buffer of the |cursor|
+template<typename T, typename Cursor>
+static inline void
+cursor_fill(Cursor *cursor,
+                size_t (*decode)(const uint8_t *, T *, T *, size_t, size_t *))
 {
-  return vbyte::sorted_search(in, length, value, previous, actual);
+  size_t count;
+  cursor->consumed += decode(cursor->in + cursor->consumed, cursor->buffer,
+                  &cursor->previous, cursor->length - cursor->decoded, &count);
+  cursor->decoded += count;
+  cursor->buffered = (uint32_t)count;
+  cursor->position = 0;
 }
 
-size_t
-vbyte_append_sorted32(uint8_t *end, uint32_t previous, uint32_t value)
+template<typename T, typename Cursor, typename Sample>
+static inline void
+cursor_init(Cursor *cursor, const uint8_t *in, size_t length, T previous,
+                const Sample *samples, size_t interval,
+                size_t (*decode)(const uint8_t *, T *, T *, size_t, size_t *))
 {
-  assert(value > previous);
-  return vbyte::write_int(end, value - previous);
+  cursor->in = in;
+  cursor->length = length;
+  cursor->index = 0;
+  cursor->consumed = 0;
+  cursor->decoded = 0;
+  cursor->samples = samples;
+  cursor->interval = interval;
+  cursor->previous = previous;
+  cursor->position = 0;
+  cursor->buffered = 0;
+  if (length > 0)
+    cursor_fill(cursor, decode);
 }
 
-size_t
-vbyte_append_sorted64(uint8_t *end, uint64_t previous, uint64_t value)
+template<typename T, typename Cursor>
+static inline int
+cursor_next(Cursor *cursor,
+                size_t (*decode)(const uint8_t *, T *, T *, size_t, size_t *))
 {
-  assert(value > previous);
-  return vbyte::write_int(end, value - previous);
+  if (cursor->index + 1 >= cursor->length) {
+    cursor->index = cursor->length;
+    return 0;
+  }
+  cursor->index++;
+  if (++cursor->position == cursor->buffered)
+    cursor_fill(cursor, decode);
+  return 1;
 }
 
-size_t
-vbyte_append_unsorted32(uint8_t *end, uint32_t value)
+template<typename T, typename Cursor>
+static inline int
+cursor_skip_to(Cursor *cursor, T value,
+                size_t (*decode)(const uint8_t *, T *, T *, size_t, size_t *))
 {
-  return vbyte::write_int(end, value);
+  if (cursor->index >= cursor->length)
+    return 0;
+  if (cursor->buffer[cursor->position] >= value)
+    return 1;
+
+  if (cursor->samples) {
+    // gallop over the samples behind the current block, looking for the
+    // first sample which does not compare less than |value|
+    size_t count = (cursor->length + cursor->interval - 1) / cursor->interval;
+    size_t block = cursor->index / cursor->interval;
+    size_t low = block + 1;
+    size_t high = block + 1;
+    size_t step = 1;
+    while (high < count && cursor->samples[high].previous < value) {
+      low = high + 1;
+      high += step;
+      step *= 2;
+    }
+    if (high > count)
+      high = count;
+    while (low < high) {
+      size_t middle = low + (high - low) / 2;
+      if (cursor->samples[middle].previous < value)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+
+    // the lower bound is in the block in front of that sample
+    if (low - 1 > block) {
+      cursor->consumed = cursor->samples[low - 1].offset;
+      cursor->previous = cursor->samples[low - 1].previous;
+      cursor->decoded = (low - 1) * cursor->interval;
+      cursor->index = cursor->decoded;
+      cursor_fill(cursor, decode);
+    }
+  }
+
+  // skip buffers whose last integer is less than |value|
+  while (cursor->buffer[cursor->buffered - 1] < value) {
+    if (cursor->decoded == cursor->length) {
+      cursor->index = cursor->length;
+      return 0;
+    }
+    cursor->index = cursor->decoded;
+    cursor_fill(cursor, decode);
+  }
+  while (cursor->buffer[cursor->position] < value) {
+    cursor->position++;
+    cursor->index++;
+  }
+  return 1;
+}
+
+template<typename T, typename Cursor>
+static inline int
+reverse_cursor_init_last(Cursor *cursor, const uint8_t *in, size_t size,
+                size_t length, T last)
+{
+  if (length == 0)
+    return 0;
+
+  cursor->in = in;
+  cursor->offset = locate_backward(in, size, 1);
+  cursor->index = length - 1;
+  cursor->current = last;
+  read_int(in + cursor->offset, &cursor->delta);
+  return 1;
+}
+
+template<typename T, typename Cursor>
+static inline int
+reverse_cursor_init(Cursor *cursor, const uint8_t *in, size_t size,
+                T previous,
+                size_t (*uncompress)(const uint8_t *, T *, size_t))
+{
+  size_t count = vbyte_count(in, size);
+  if (count == 0)
+    return 0;
+
+  skip_sorted(in, count, &previous, uncompress);
+  return reverse_cursor_init_last(cursor, in, size, count, previous);
+}
+
+template<typename T, typename Cursor>
+static inline int
+reverse_cursor_prev(Cursor *cursor)
+{
+  if (cursor->index == 0)
+    return 0;
+
+  cursor->current -= cursor->delta;
+  cursor->offset = locate_backward(cursor->in, cursor->offset - 1, 0);
+  cursor->index--;
+  read_int(cursor->in + cursor->offset, &cursor->delta);
+  return 1;
+}
+
+// decodes a sorted sequence in chunks, for merging it with other sequences
+template<typename T>
+struct SortedChunkReader {
+  enum { kCapacity = 256 };
+
+  typedef size_t (*Uncompress)(const uint8_t *, T *, T, size_t);
+
+  SortedChunkReader() {
+  }
+
+  SortedChunkReader(const uint8_t *in_, size_t length, T previous_,
+                  Uncompress uncompress_) {
+    open(in_, length, previous_, uncompress_);
+  }
+
+  void open(const uint8_t *in_, size_t length, T previous_,
+                  Uncompress uncompress_) {
+    in = in_;
+    remaining = length;
+    previous = previous_;
+    size = 0;
+    position = 0;
+    uncompress = uncompress_;
+  }
+
+  size_t available() const {
+    return size - position;
+  }
+
+  const T *current() const {
+    return &buffer[position];
+  }
+
+  // moves the integers which were not yet processed to the front of the
+  // buffer, and decodes as many new integers as possible behind them
+  void refill() {
+    size_t keep = size - position;
+    memmove(&buffer[0], &buffer[position], keep * sizeof(T));
+    size_t count = kCapacity - keep;
+    if (count > remaining)
+      count = remaining;
+    if (count > 0) {
+      in += uncompress(in, &buffer[keep], previous, count);
+      previous = buffer[keep + count - 1];
+      remaining -= count;
+    }
+    size = keep + count;
+    position = 0;
+  }
+
+  // refills the buffer if it runs low, returns false if it is empty
+  bool fill() {
+    if (available() < 16 && remaining > 0)
+      refill();
+    return available() > 0;
+  }
+
+  const uint8_t *in;
+  size_t remaining;
+  T previous;
+  size_t size;
+  size_t position;
+  Uncompress uncompress;
+  T buffer[kCapacity];
+};
+
+template<typename T>
+static inline size_t
+intersect_sorted(const uint8_t *in1, size_t length1, T previous1,
+                const uint8_t *in2, size_t length2, T previous2, T *out,
+                size_t (*uncompress)(const uint8_t *, T *, T, size_t),
+                size_t (*intersect)(const T *, size_t, const T *, size_t, T *,
+                        size_t *, size_t *))
+{
+  SortedChunkReader<T> a(in1, length1, previous1, uncompress);
+  SortedChunkReader<T> b(in2, length2, previous2, uncompress);
+  size_t count = 0;
+
+  while (a.fill() && b.fill()) {
+    // the vectorized intersection processes blocks of integers, as long as
+    // both buffers have enough of them
+    if (intersect) {
+      size_t pa, pb;
+      count += intersect(a.current(), a.available(), b.current(),
+                      b.available(), out + count, &pa, &pb);
+      a.position += pa;
+      b.position += pb;
+      if (pa > 0 || pb > 0)
+        continue;
+    }
+
+    T x = *a.current();
+    T y = *b.current();
+    if (x <= y)
+      a.position++;
+    if (y <= x)
+      b.position++;
+    if (x == y)
+      out[count++] = x;
+  }
+  return count;
+}
+
+template<typename T>
+static inline size_t
+union_sorted(const uint8_t *const *inputs, const size_t *lengths,
+                const T *previous, size_t count, uint8_t *out,
+                size_t *length,
+                size_t (*uncompress)(const uint8_t *, T *, T, size_t),
+                size_t (*compress)(const T *, uint8_t *, T, size_t))
+{
+  // the readers live on the stack
+  if (count > VBYTE_UNION_MAX_INPUTS) {
+    *length = 0;
+    return (size_t)-1;
+  }
+
+  SortedChunkReader<T> readers[VBYTE_UNION_MAX_INPUTS];
+  // the readers which still have integers
+  SortedChunkReader<T> *active[VBYTE_UNION_MAX_INPUTS];
+  size_t pending = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    readers[i].open(inputs[i], lengths[i], previous[i], uncompress);
+    if (readers[i].fill())
+      active[pending++] = &readers[i];
+  }
+
+  // the merged integers are collected and then compressed in chunks
+  T buffer[SortedChunkReader<T>::kCapacity];
+  size_t buffered = 0;
+  size_t written = 0;
+  size_t total = 0;
+  T last = 0;
+
+  while (pending > 0) {
+    // find the reader with the smallest integer with a linear scan; there
+    // are only a few of them
+    size_t smallest = 0;
+    for (size_t i = 1; i < pending; i++)
+      if (*active[i]->current() < *active[smallest]->current())
+        smallest = i;
+    SortedChunkReader<T> *reader = active[smallest];
+
+    // and the smallest integer of the other readers
+    bool bounded = false;
+    T bound = 0;
+    for (size_t i = 0; i < pending; i++) {
+      if (i != smallest && (!bounded || *active[i]->current() < bound)) {
+        bound = *active[i]->current();
+        bounded = true;
+      }
+    }
+
+    // take integers from this input as long as they are not greater than
+    // the smallest integer of the other inputs
+    do {
+      T value = *reader->current();
+      reader->position++;
+
+      // skip duplicates
+      if (total > 0 && value == (buffered > 0
+                              ? buffer[buffered - 1]
+                              : last))
+        continue;
+      buffer[buffered++] = value;
+      total++;
+      if (buffered == SortedChunkReader<T>::kCapacity) {
+        written += compress(buffer, out + written, last, buffered);
+        last = buffer[buffered - 1];
+        buffered = 0;
+      }
+    } while (reader->fill() && (!bounded || *reader->current() <= bound));
+
+    if (reader->available() == 0)
+      active[smallest] = active[--pending];
+  }
+  if (buffered > 0)
+    written += compress(buffer, out + written, last, buffered);
+
+  *length = total;
+  return written;
+}
+
+// stores the results of a set operation in an array of integers
+template<typename T>
+struct ArraySink {
+  ArraySink(T *out_)
+    : out(out_), count(0) {
+  }
+
+  // returns room for up to SortedChunkReader<T>::kCapacity integers
+  T *reserve() {
+    return out + count;
+  }
+
+  void commit(size_t n) {
+    count += n;
+  }
+
+  void flush() {
+  }
+
+  T *out;
+  size_t count;
+};
+
+// compresses the results of a set operation in chunks
+template<typename T>
+struct CompressedSink {
+  enum { kCapacity = 2 * SortedChunkReader<T>::kCapacity };
+
+  typedef size_t (*Compress)(const T *, uint8_t *, T, size_t);
+
+  CompressedSink(uint8_t *out_, T previous_, Compress compress_)
+    : out(out_), written(0), count(0), buffered(0), previous(previous_),
+      compress(compress_) {
+  }
+
+  T *reserve() {
+    if (buffered > kCapacity - SortedChunkReader<T>::kCapacity)
+      flush();
+    return &buffer[buffered];
+  }
+
+  void commit(size_t n) {
+    buffered += n;
+    count += n;
+  }
+
+  void flush() {
+    if (buffered == 0)
+      return;
+    written += compress(buffer, out + written, previous, buffered);
+    previous = buffer[buffered - 1];
+    buffered = 0;
+  }
+
+  uint8_t *out;
+  size_t written;
+  size_t count;
+  size_t buffered;
+  T previous;
+  Compress compress;
+  T buffer[kCapacity];
+};
+
+template<typename T, typename Sink>
+static inline void
+difference_sorted(const uint8_t *in1, size_t length1, T previous1,
+                const uint8_t *in2, size_t length2, T previous2, Sink &sink,
+                size_t (*uncompress)(const uint8_t *, T *, T, size_t),
+                size_t (*difference)(const T *, size_t, const T *, size_t, T *,
+                        size_t *, size_t *, int *))
+{
+  SortedChunkReader<T> a(in1, length1, previous1, uncompress);
+  SortedChunkReader<T> b(in2, length2, previous2, uncompress);
+  // the integers at the current position of |a| which were found in |b|
+  int matched = 0;
+
+  while (a.fill() && b.fill()) {
+    if (difference) {
+      size_t pa, pb;
+      sink.commit(difference(a.current(), a.available(), b.current(),
+                              b.available(), sink.reserve(), &pa, &pb,
+                              &matched));
+      a.position += pa;
+      b.position += pb;
+      if (pa > 0 || pb > 0)
+        continue;
+    }
+
+    T x = *a.current();
+    T y = *b.current();
+    if (x <= y) {
+      if (x < y && !(matched & 1)) {
+        *sink.reserve() = x;
+        sink.commit(1);
+      }
+      a.position++;
+      matched >>= 1;
+    }
+    if (y <= x)
+      b.position++;
+  }
+
+  // all remaining integers of |a| are not in |b|
+  while (a.fill()) {
+    if (!(matched & 1)) {
+      *sink.reserve() = *a.current();
+      sink.commit(1);
+    }
+    a.position++;
+    matched >>= 1;
+  }
+  sink.flush();
+}
+
+} // namespace vbyte
+
+size_t
+vbyte_compressed_size_sorted32(const uint32_t *in, size_t length,
+                uint32_t previous)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_encode_kernels *simd = vbyte::masked_vbyte_encode())
+    return simd->size_delta(in, (uint64_t)length, previous);
+#endif
+  return vbyte::compressed_size_sorted(in, length, previous);
+}
+
+size_t
+vbyte_compressed_size_sorted64(const uint64_t *in, size_t length,
+                uint64_t previous)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_encode_kernels *simd = vbyte::masked_vbyte_encode())
+    return simd->size_delta64(in, (uint64_t)length, previous);
+#endif
+  return vbyte::compressed_size_sorted(in, length, previous);
+}
+
+size_t
+vbyte_compressed_size_unsorted32(const uint32_t *in, size_t length)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_encode_kernels *simd = vbyte::masked_vbyte_encode())
+    return simd->size(in, (uint64_t)length);
+#endif
+  return vbyte::compressed_size_unsorted(in, length);
+}
+
+size_t
+vbyte_compressed_size_unsorted64(const uint64_t *in, size_t length)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_encode_kernels *simd = vbyte::masked_vbyte_encode())
+    return simd->size64(in, (uint64_t)length);
+#endif
+  return vbyte::compressed_size_unsorted(in, length);
+}
+
+size_t
+vbyte_compress_unsorted32(const uint32_t *in, uint8_t *out, size_t length)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_encode_kernels *simd = vbyte::masked_vbyte_encode())
+    return simd->encode(in, out, (uint64_t)length);
+#endif
+  return vbyte::compress_unsorted(in, out, length);
+}
+
+size_t
+vbyte_compress_unsorted64(const uint64_t *in, uint8_t *out, size_t length)
+{
+  return vbyte::compress_unsorted(in, out, length);
+}
+
+size_t
+vbyte_compress_unsorted32_bounded(const uint32_t *in, size_t length,
+                uint8_t *out, size_t capacity, size_t *consumed)
+{
+  return vbyte::compress_bounded<uint32_t>(in, length, out, capacity, 0,
+                  consumed);
+}
+
+size_t
+vbyte_compress_unsorted64_bounded(const uint64_t *in, size_t length,
+                uint8_t *out, size_t capacity, size_t *consumed)
+{
+  return vbyte::compress_bounded<uint64_t>(in, length, out, capacity, 0,
+                  consumed);
+}
+
+size_t
+vbyte_compress_sorted32_bounded(const uint32_t *in, size_t length,
+                uint8_t *out, size_t capacity, uint32_t previous,
+                size_t *consumed)
+{
+  return vbyte::compress_bounded(in, length, out, capacity, &previous,
+                  consumed);
+}
+
+size_t
+vbyte_compress_sorted64_bounded(const uint64_t *in, size_t length,
+                uint8_t *out, size_t capacity, uint64_t previous,
+                size_t *consumed)
+{
+  return vbyte::compress_bounded(in, length, out, capacity, &previous,
+                  consumed);
+}
+
+size_t
+vbyte_uncompress_unsorted32(const uint8_t *in, uint32_t *out, size_t length)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    return simd->decode(in, out, (uint64_t)length);
+#endif
+  return vbyte::uncompress_unsorted(in, out, length);
+}
+
+size_t
+vbyte_uncompress_unsorted64(const uint8_t *in, uint64_t *out, size_t length)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    return simd->decode64(in, out, (uint64_t)length);
+#endif
+  return vbyte::uncompress_unsorted(in, out, length);
+}
+
+size_t
+vbyte_compress_sorted32(const uint32_t *in, uint8_t *out, uint32_t previous,
+                size_t length)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_encode_kernels *simd = vbyte::masked_vbyte_encode())
+    return simd->encode_delta(in, out, (uint64_t)length, previous);
+#endif
+  return vbyte::compress_sorted(in, out, previous, length);
+}
+
+size_t
+vbyte_compress_sorted64(const uint64_t *in, uint8_t *out, uint64_t previous,
+                size_t length)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_encode_kernels *simd = vbyte::masked_vbyte_encode())
+    return simd->encode_delta64(in, out, (uint64_t)length, previous);
+#endif
+  return vbyte::compress_sorted(in, out, previous, length);
+}
+
+size_t
+vbyte_uncompress_sorted32(const uint8_t *in, uint32_t *out, uint32_t previous,
+                size_t length)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    return simd->decode_delta(in, out, (uint64_t)length, previous);
+#endif
+  return vbyte::uncompress_sorted(in, out, previous, length);
+}
+
+size_t
+vbyte_uncompress_sorted64(const uint8_t *in, uint64_t *out, uint64_t previous,
+                size_t length)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    return simd->decode_delta64(in, out, (uint64_t)length, previous);
+#endif
+  return vbyte::uncompress_sorted(in, out, previous, length);
+}
+
+size_t
+vbyte_uncompress_unsorted32_bytes(const uint8_t *in, size_t size,
+                uint32_t *out)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    return simd->decode_fromcompressedsize(in, out, size);
+#endif
+  return vbyte::uncompress_unsorted_bytes(in, size, out);
+}
+
+size_t
+vbyte_uncompress_unsorted64_bytes(const uint8_t *in, size_t size,
+                uint64_t *out)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte()) {
+    size_t length = simd->count(in, (uint64_t)size);
+    simd->decode64(in, out, (uint64_t)length);
+    return length;
+  }
+#endif
+  return vbyte::uncompress_unsorted_bytes(in, size, out);
+}
+
+size_t
+vbyte_uncompress_sorted32_bytes(const uint8_t *in, size_t size,
+                uint32_t *out, uint32_t previous)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    return simd->decode_fromcompressedsize_delta(in, out, size, previous);
+#endif
+  return vbyte::uncompress_sorted_bytes(in, size, out, previous);
+}
+
+size_t
+vbyte_uncompress_sorted64_bytes(const uint8_t *in, size_t size,
+                uint64_t *out, uint64_t previous)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte()) {
+    size_t length = simd->count(in, (uint64_t)size);
+    simd->decode_delta64(in, out, (uint64_t)length, previous);
+    return length;
+  }
+#endif
+  return vbyte::uncompress_sorted_bytes(in, size, out, previous);
+}
+
+size_t
+vbyte_uncompress_range_unsorted32(const uint8_t *in, size_t size,
+                size_t begin, size_t end, uint32_t *out)
+{
+  assert(begin <= end);
+  size_t offset = vbyte_locate(in, size, begin);
+  return offset + vbyte_uncompress_unsorted32(in + offset, out, end - begin);
+}
+
+size_t
+vbyte_uncompress_range_unsorted64(const uint8_t *in, size_t size,
+                size_t begin, size_t end, uint64_t *out)
+{
+  assert(begin <= end);
+  size_t offset = vbyte_locate(in, size, begin);
+  return offset + vbyte_uncompress_unsorted64(in + offset, out, end - begin);
+}
+
+size_t
+vbyte_uncompress_range_sorted32(const uint8_t *in, size_t size,
+                uint32_t previous, size_t begin, size_t end, uint32_t *out)
+{
+  (void)size;
+  assert(begin <= end);
+  size_t offset = vbyte::skip_sorted(in, begin, &previous,
+                  vbyte_uncompress_unsorted32);
+  return offset + vbyte_uncompress_sorted32(in + offset, out, previous,
+                  end - begin);
+}
+
+size_t
+vbyte_uncompress_range_sorted64(const uint8_t *in, size_t size,
+                uint64_t previous, size_t begin, size_t end, uint64_t *out)
+{
+  (void)size;
+  assert(begin <= end);
+  size_t offset = vbyte::skip_sorted(in, begin, &previous,
+                  vbyte_uncompress_unsorted64);
+  return offset + vbyte_uncompress_sorted64(in + offset, out, previous,
+                  end - begin);
+}
+
+uint32_t
+vbyte_select_sorted32(const uint8_t *in, size_t size, uint32_t previous,
+                size_t index)
+{
+  (void)size;
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    return simd->select_delta(in, (uint64_t)size, previous, index);
+#endif
+  return vbyte::select_sorted<uint32_t>(in, previous, index);
+}
+
+uint64_t
+vbyte_select_sorted64(const uint8_t *in, size_t size, uint64_t previous,
+                size_t index)
+{
+  (void)size;
+  return vbyte::select_sorted<uint64_t>(in, previous, index);
+}
+
+uint32_t
+vbyte_select_unsorted32(const uint8_t *in, size_t size, size_t index)
+{
+  (void)size;
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    return simd->select(in, (uint64_t)size, index);
+#endif
+  return vbyte::select_unsorted<uint32_t>(in, index);
+}
+
+uint64_t
+vbyte_select_unsorted64(const uint8_t *in, size_t size, size_t index)
+{
+  (void)size;
+  return vbyte::select_unsorted<uint64_t>(in, index);
+}
+
+void
+vbyte_select_many_sorted32(const uint8_t *in, size_t size, uint32_t previous,
+                const size_t *indices, size_t count, uint32_t *out)
+{
+  (void)size;
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte()) {
+    simd->select_many_delta(in, previous, indices, count, out);
+    return;
+  }
+#endif
+  vbyte::select_many_sorted(in, previous, indices, count, out);
+}
+
+void
+vbyte_select_many_sorted64(const uint8_t *in, size_t size, uint64_t previous,
+                const size_t *indices, size_t count, uint64_t *out)
+{
+  (void)size;
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte()) {
+    simd->select_many_delta64(in, previous, indices, count, out);
+    return;
+  }
+#endif
+  vbyte::select_many_sorted(in, previous, indices, count, out);
+}
+
+void
+vbyte_select_many_unsorted32(const uint8_t *in, size_t size,
+                const size_t *indices, size_t count, uint32_t *out)
+{
+  (void)size;
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte()) {
+    simd->select_many(in, indices, count, out);
+    return;
+  }
+#endif
+  vbyte::select_many_unsorted(in, indices, count, out);
+}
+
+void
+vbyte_select_many_unsorted64(const uint8_t *in, size_t size,
+                const size_t *indices, size_t count, uint64_t *out)
+{
+  (void)size;
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte()) {
+    simd->select_many64(in, indices, count, out);
+    return;
+  }
+#endif
+  vbyte::select_many_unsorted(in, indices, count, out);
+}
+
+size_t
+vbyte_build_index_sorted32(const uint8_t *in, size_t length,
+                uint32_t previous, size_t interval, vbyte_sample32 *samples)
+{
+  return vbyte::build_index_sorted(in, length, previous, interval, samples,
+                  vbyte_uncompress_unsorted32);
+}
+
+size_t
+vbyte_build_index_sorted64(const uint8_t *in, size_t length,
+                uint64_t previous, size_t interval, vbyte_sample64 *samples)
+{
+  return vbyte::build_index_sorted(in, length, previous, interval, samples,
+                  vbyte_uncompress_unsorted64);
+}
+
+uint32_t
+vbyte_select_sorted_indexed32(const uint8_t *in, size_t size,
+                const vbyte_sample32 *samples, size_t interval, size_t index)
+{
+  (void)size;
+  const vbyte_sample32 *sample = &samples[index / interval];
+  index %= interval;
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte()) {
+    // the kernel only decodes groups if it can look ahead; at least
+    // |index + 1| integers follow the sample, and every integer has at most
+    // 5 bytes
+    uint64_t length = (size - sample->offset) / 5;
+    if (length < index + 1)
+      length = index + 1;
+    return simd->select_delta(in + sample->offset, length, sample->previous,
+                    index);
+  }
+#endif
+  return vbyte::select_sorted<uint32_t>(in + sample->offset,
+                  sample->previous, index);
+}
+
+uint64_t
+vbyte_select_sorted_indexed64(const uint8_t *in, size_t size,
+                const vbyte_sample64 *samples, size_t interval, size_t index)
+{
+  (void)size;
+  const vbyte_sample64 *sample = &samples[index / interval];
+  return vbyte::select_sorted<uint64_t>(in + sample->offset,
+                  sample->previous, index % interval);
+}
+
+size_t
+vbyte_search_unsorted32(const uint8_t *in, size_t length, uint32_t value)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    return simd->search(in, (uint64_t)length, value);
+#endif
+  return vbyte::search_unsorted(in, length, value);
+}
+
+size_t
+vbyte_search_unsorted64(const uint8_t *in, size_t length, uint64_t value)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    return simd->search64(in, (uint64_t)length, value);
+#endif
+  return vbyte::search_unsorted(in, length, value);
+}
+
+void
+vbyte_cursor_init32(vbyte_cursor32 *cursor, const uint8_t *in, size_t length,
+                uint32_t previous, const vbyte_sample32 *samples,
+                size_t interval)
+{
+  vbyte::cursor_init(cursor, in, length, previous, samples, interval,
+                  vbyte::decode_group_sorted32);
+}
+
+void
+vbyte_cursor_init64(vbyte_cursor64 *cursor, const uint8_t *in, size_t length,
+                uint64_t previous, const vbyte_sample64 *samples,
+                size_t interval)
+{
+  vbyte::cursor_init(cursor, in, length, previous, samples, interval,
+                  vbyte::decode_group_sorted64);
+}
+
+int
+vbyte_cursor_next32(vbyte_cursor32 *cursor)
+{
+  return vbyte::cursor_next(cursor, vbyte::decode_group_sorted32);
+}
+
+int
+vbyte_cursor_next64(vbyte_cursor64 *cursor)
+{
+  return vbyte::cursor_next(cursor, vbyte::decode_group_sorted64);
+}
+
+int
+vbyte_cursor_skip_to32(vbyte_cursor32 *cursor, uint32_t value)
+{
+  return vbyte::cursor_skip_to(cursor, value,
+                  vbyte::decode_group_sorted32);
+}
+
+int
+vbyte_cursor_skip_to64(vbyte_cursor64 *cursor, uint64_t value)
+{
+  return vbyte::cursor_skip_to(cursor, value,
+                  vbyte::decode_group_sorted64);
+}
+
+uint32_t
+vbyte_cursor_current32(const vbyte_cursor32 *cursor)
+{
+  return cursor->buffer[cursor->position];
+}
+
+uint64_t
+vbyte_cursor_current64(const vbyte_cursor64 *cursor)
+{
+  return cursor->buffer[cursor->position];
+}
+
+size_t
+vbyte_cursor_index32(const vbyte_cursor32 *cursor)
+{
+  return cursor->index;
+}
+
+size_t
+vbyte_cursor_index64(const vbyte_cursor64 *cursor)
+{
+  return cursor->index;
+}
+
+int
+vbyte_reverse_cursor_init32(vbyte_reverse_cursor32 *cursor, const uint8_t *in,
+                size_t size, uint32_t previous)
+{
+  return vbyte::reverse_cursor_init(cursor, in, size, previous,
+                  vbyte_uncompress_unsorted32);
+}
+
+int
+vbyte_reverse_cursor_init_last32(vbyte_reverse_cursor32 *cursor,
+                const uint8_t *in, size_t size, size_t length, uint32_t last)
+{
+  return vbyte::reverse_cursor_init_last(cursor, in, size, length, last);
+}
+
+int
+vbyte_reverse_cursor_init64(vbyte_reverse_cursor64 *cursor, const uint8_t *in,
+                size_t size, uint64_t previous)
+{
+  return vbyte::reverse_cursor_init(cursor, in, size, previous,
+                  vbyte_uncompress_unsorted64);
+}
+
+int
+vbyte_reverse_cursor_init_last64(vbyte_reverse_cursor64 *cursor,
+                const uint8_t *in, size_t size, size_t length, uint64_t last)
+{
+  return vbyte::reverse_cursor_init_last(cursor, in, size, length, last);
+}
+
+int
+vbyte_reverse_cursor_prev32(vbyte_reverse_cursor32 *cursor)
+{
+  return vbyte::reverse_cursor_prev<uint32_t>(cursor);
+}
+
+int
+vbyte_reverse_cursor_prev64(vbyte_reverse_cursor64 *cursor)
+{
+  return vbyte::reverse_cursor_prev<uint64_t>(cursor);
+}
+
+uint32_t
+vbyte_reverse_cursor_current32(const vbyte_reverse_cursor32 *cursor)
+{
+  return cursor->current;
+}
+
+uint64_t
+vbyte_reverse_cursor_current64(const vbyte_reverse_cursor64 *cursor)
+{
+  return cursor->current;
+}
+
+size_t
+vbyte_reverse_cursor_index32(const vbyte_reverse_cursor32 *cursor)
+{
+  return cursor->index;
+}
+
+size_t
+vbyte_reverse_cursor_index64(const vbyte_reverse_cursor64 *cursor)
+{
+  return cursor->index;
+}
+
+size_t
+vbyte_split_sorted32(const uint8_t *in, size_t size, uint32_t previous,
+                uint8_t *left, size_t *left_size, uint8_t *right,
+                size_t *right_size)
+{
+  return vbyte::split_sorted(in, size, previous, left, left_size, right,
+                  right_size, vbyte_uncompress_unsorted32);
+}
+
+size_t
+vbyte_split_sorted_indexed32(const uint8_t *in, size_t size, size_t length,
+                const vbyte_sample32 *samples, size_t interval, uint8_t *left,
+                size_t *left_size, uint8_t *right, size_t *right_size)
+{
+  return vbyte::split_sorted_indexed(in, size, length, samples, interval,
+                  left, left_size, right, right_size,
+                  vbyte_uncompress_unsorted32);
+}
+
+size_t
+vbyte_split_sorted64(const uint8_t *in, size_t size, uint64_t previous,
+                uint8_t *left, size_t *left_size, uint8_t *right,
+                size_t *right_size)
+{
+  return vbyte::split_sorted(in, size, previous, left, left_size, right,
+                  right_size, vbyte_uncompress_unsorted64);
+}
+
+size_t
+vbyte_split_sorted_indexed64(const uint8_t *in, size_t size, size_t length,
+                const vbyte_sample64 *samples, size_t interval, uint8_t *left,
+                size_t *left_size, uint8_t *right, size_t *right_size)
+{
+  return vbyte::split_sorted_indexed(in, size, length, samples, interval,
+                  left, left_size, right, right_size,
+                  vbyte_uncompress_unsorted64);
+}
+
+size_t
+vbyte_concat_sorted32(const uint8_t *in1, size_t size1, uint32_t last,
+                const uint8_t *in2, size_t size2, uint32_t previous,
+                uint8_t *out)
+{
+  return vbyte::concat_sorted(in1, size1, last, in2, size2, previous, out);
+}
+
+size_t
+vbyte_concat_sorted64(const uint8_t *in1, size_t size1, uint64_t last,
+                const uint8_t *in2, size_t size2, uint64_t previous,
+                uint8_t *out)
+{
+  return vbyte::concat_sorted(in1, size1, last, in2, size2, previous, out);
+}
+
+size_t
+vbyte_search_lower_bound_sorted32(const uint8_t *in, size_t length,
+                uint32_t value, uint32_t previous, uint32_t *actual)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    return (size_t)simd->search_delta(in, (uint64_t)length, previous,
+                  value, actual);
+#endif
+  return vbyte::sorted_search(in, length, value, previous, actual);
+}
+
+size_t
+vbyte_search_lower_bound_sorted64(const uint8_t *in, size_t length,
+                uint64_t value, uint64_t previous, uint64_t *actual)
+{
+  return vbyte::sorted_search(in, length, value, previous, actual);
+}
+
+void
+vbyte_search_lower_bound_many_sorted32(const uint8_t *in, size_t length,
+                uint32_t previous, const uint32_t *values, size_t count,
+                size_t *positions, uint32_t *actual)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte()) {
+    simd->search_many_delta(in, (uint64_t)length, previous, values, count,
+                  positions, actual);
+    return;
+  }
+#endif
+  vbyte::sorted_search_many(in, length, previous, values, count, positions,
+                  actual);
+}
+
+void
+vbyte_search_lower_bound_many_sorted64(const uint8_t *in, size_t length,
+                uint64_t previous, const uint64_t *values, size_t count,
+                size_t *positions, uint64_t *actual)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte()) {
+    simd->search_many_delta64(in, (uint64_t)length, previous, values, count,
+                  positions, actual);
+    return;
+  }
+#endif
+  vbyte::sorted_search_many(in, length, previous, values, count, positions,
+                  actual);
+}
+
+size_t
+vbyte_count_range_sorted32(const uint8_t *in, size_t length,
+                uint32_t previous, uint32_t low, uint32_t high)
+{
+  if (low >= high)
+    return 0;
+
+  // the lower bounds of both ends of the range are found in the same pass
+  uint32_t keys[2] = {low, high};
+  size_t positions[2];
+  uint32_t actual[2];
+  vbyte_search_lower_bound_many_sorted32(in, length, previous, keys, 2,
+                  positions, actual);
+  return positions[1] - positions[0];
+}
+
+size_t
+vbyte_count_range_sorted64(const uint8_t *in, size_t length,
+                uint64_t previous, uint64_t low, uint64_t high)
+{
+  if (low >= high)
+    return 0;
+
+  uint64_t keys[2] = {low, high};
+  size_t positions[2];
+  uint64_t actual[2];
+  vbyte_search_lower_bound_many_sorted64(in, length, previous, keys, 2,
+                  positions, actual);
+  return positions[1] - positions[0];
+}
+
+size_t
+vbyte_search_lower_bound_sorted_indexed32(const uint8_t *in, size_t length,
+                const vbyte_sample32 *samples, size_t interval, uint32_t value,
+                uint32_t *actual)
+{
+  return vbyte::search_lower_bound_indexed(in, length, samples, interval,
+                  value, actual, vbyte_search_lower_bound_sorted32);
+}
+
+size_t
+vbyte_search_lower_bound_sorted_indexed64(const uint8_t *in, size_t length,
+                const vbyte_sample64 *samples, size_t interval, uint64_t value,
+                uint64_t *actual)
+{
+  return vbyte::search_lower_bound_indexed(in, length, samples, interval,
+                  value, actual, vbyte_search_lower_bound_sorted64);
+}
+
+size_t
+vbyte_intersect_sorted32(const uint8_t *in1, size_t length1,
+                uint32_t previous1, const uint8_t *in2, size_t length2,
+                uint32_t previous2, uint32_t *out)
+{
+  size_t (*intersect)(const uint32_t *, size_t, const uint32_t *, size_t,
+                  uint32_t *, size_t *, size_t *) = 0;
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    intersect = simd->intersect;
+#endif
+  return vbyte::intersect_sorted(in1, length1, previous1, in2, length2,
+                  previous2, out, vbyte_uncompress_sorted32, intersect);
+}
+
+size_t
+vbyte_intersect_sorted64(const uint8_t *in1, size_t length1,
+                uint64_t previous1, const uint8_t *in2, size_t length2,
+                uint64_t previous2, uint64_t *out)
+{
+  size_t (*intersect)(const uint64_t *, size_t, const uint64_t *, size_t,
+                  uint64_t *, size_t *, size_t *) = 0;
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    intersect = simd->intersect64;
+#endif
+  return vbyte::intersect_sorted(in1, length1, previous1, in2, length2,
+                  previous2, out, vbyte_uncompress_sorted64, intersect);
+}
+
+size_t
+vbyte_union_sorted32(const uint8_t *const *inputs, const size_t *lengths,
+                const uint32_t *previous, size_t count, uint8_t *out,
+                size_t *length)
+{
+  return vbyte::union_sorted(inputs, lengths, previous, count, out,
+                  length, vbyte_uncompress_sorted32, vbyte_compress_sorted32);
+}
+
+size_t
+vbyte_union_sorted64(const uint8_t *const *inputs, const size_t *lengths,
+                const uint64_t *previous, size_t count, uint8_t *out,
+                size_t *length)
+{
+  return vbyte::union_sorted(inputs, lengths, previous, count, out,
+                  length, vbyte_uncompress_sorted64, vbyte_compress_sorted64);
+}
+
+size_t
+vbyte_difference_sorted32(const uint8_t *in1, size_t length1,
+                uint32_t previous1, const uint8_t *in2, size_t length2,
+                uint32_t previous2, uint32_t *out)
+{
+  size_t (*difference)(const uint32_t *, size_t, const uint32_t *, size_t,
+                  uint32_t *, size_t *, size_t *, int *) = 0;
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    difference = simd->difference;
+#endif
+  vbyte::ArraySink<uint32_t> sink(out);
+  vbyte::difference_sorted(in1, length1, previous1, in2, length2, previous2,
+                  sink, vbyte_uncompress_sorted32, difference);
+  return sink.count;
+}
+
+size_t
+vbyte_difference_sorted64(const uint8_t *in1, size_t length1,
+                uint64_t previous1, const uint8_t *in2, size_t length2,
+                uint64_t previous2, uint64_t *out)
+{
+  size_t (*difference)(const uint64_t *, size_t, const uint64_t *, size_t,
+                  uint64_t *, size_t *, size_t *, int *) = 0;
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    difference = simd->difference64;
+#endif
+  vbyte::ArraySink<uint64_t> sink(out);
+  vbyte::difference_sorted(in1, length1, previous1, in2, length2, previous2,
+                  sink, vbyte_uncompress_sorted64, difference);
+  return sink.count;
+}
+
+size_t
+vbyte_difference_compressed_sorted32(const uint8_t *in1, size_t length1,
+                uint32_t previous1, const uint8_t *in2, size_t length2,
+                uint32_t previous2, uint8_t *out, uint32_t previous, size_t *length)
+{
+  size_t (*difference)(const uint32_t *, size_t, const uint32_t *, size_t,
+                  uint32_t *, size_t *, size_t *, int *) = 0;
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    difference = simd->difference;
+#endif
+  vbyte::CompressedSink<uint32_t> sink(out, previous,
+                  vbyte_compress_sorted32);
+  vbyte::difference_sorted(in1, length1, previous1, in2, length2, previous2,
+                  sink, vbyte_uncompress_sorted32, difference);
+  *length = sink.count;
+  return sink.written;
+}
+
+size_t
+vbyte_difference_compressed_sorted64(const uint8_t *in1, size_t length1,
+                uint64_t previous1, const uint8_t *in2, size_t length2,
+                uint64_t previous2, uint8_t *out, uint64_t previous, size_t *length)
+{
+  size_t (*difference)(const uint64_t *, size_t, const uint64_t *, size_t,
+                  uint64_t *, size_t *, size_t *, int *) = 0;
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    difference = simd->difference64;
+#endif
+  vbyte::CompressedSink<uint64_t> sink(out, previous,
+                  vbyte_compress_sorted64);
+  vbyte::difference_sorted(in1, length1, previous1, in2, length2, previous2,
+                  sink, vbyte_uncompress_sorted64, difference);
+  *length = sink.count;
+  return sink.written;
+}
+
+uint32_t
+vbyte_select_last_sorted32(const uint8_t *in, size_t size, uint32_t previous)
+{
+  vbyte::skip_sorted(in, vbyte_count(in, size), &previous,
+                  vbyte_uncompress_unsorted32);
+  return previous;
+}
+
+uint64_t
+vbyte_select_last_sorted64(const uint8_t *in, size_t size, uint64_t previous)
+{
+  vbyte::skip_sorted(in, vbyte_count(in, size), &previous,
+                  vbyte_uncompress_unsorted64);
+  return previous;
+}
+
+size_t
+vbyte_uncompress_reverse_unsorted32(const uint8_t *in, size_t size,
+                uint32_t *out, size_t length)
+{
+  return vbyte::uncompress_reverse_unsorted(in, size, out, length,
+                  vbyte_uncompress_unsorted32);
+}
+
+size_t
+vbyte_uncompress_reverse_unsorted64(const uint8_t *in, size_t size,
+                uint64_t *out, size_t length)
+{
+  return vbyte::uncompress_reverse_unsorted(in, size, out, length,
+                  vbyte_uncompress_unsorted64);
+}
+
+size_t
+vbyte_insert_sorted32(uint8_t *in, size_t length, size_t size,
+                uint32_t previous, uint32_t value)
+{
+  return vbyte::insert_sorted(in, length, size, previous, value,
+                  vbyte_search_lower_bound_sorted32);
+}
+
+size_t
+vbyte_insert_sorted64(uint8_t *in, size_t length, size_t size,
+                uint64_t previous, uint64_t value)
+{
+  return vbyte::insert_sorted(in, length, size, previous, value,
+                  vbyte_search_lower_bound_sorted64);
+}
+
+size_t
+vbyte_erase_sorted32(uint8_t *in, size_t length, size_t size,
+                uint32_t previous, uint32_t value)
+{
+  return vbyte::erase_sorted(in, length, size, previous, value,
+                  vbyte_search_lower_bound_sorted32);
+}
+
+size_t
+vbyte_erase_sorted64(uint8_t *in, size_t length, size_t size,
+                uint64_t previous, uint64_t value)
+{
+  return vbyte::erase_sorted(in, length, size, previous, value,
+                  vbyte_search_lower_bound_sorted64);
+}
+
+size_t
+vbyte_append_sorted32(uint8_t *end, uint32_t previous, uint32_t value)
+{
+  assert(value > previous);
+  return vbyte::write_int(end, value - previous);
+}
+
+size_t
+vbyte_append_sorted64(uint8_t *end, uint64_t previous, uint64_t value)
+{
+  assert(value > previous);
+  return vbyte::write_int(end, value - previous);
+}
+
+size_t
+vbyte_append_many_sorted32(uint8_t *end, uint32_t previous,
+                const uint32_t *in, size_t length, uint32_t *last)
+{
+  assert(length == 0 || in[0] > previous);
+  for (size_t i = 1; i < length; i++)
+    assert(in[i] > in[i - 1]);
+  *last = length > 0 ? in[length - 1] : previous;
+  return vbyte_compress_sorted32(in, end, previous, length);
+}
+
+size_t
+vbyte_append_many_sorted64(uint8_t *end, uint64_t previous,
+                const uint64_t *in, size_t length, uint64_t *last)
+{
+  assert(length == 0 || in[0] > previous);
+  for (size_t i = 1; i < length; i++)
+    assert(in[i] > in[i - 1]);
+  *last = length > 0 ? in[length - 1] : previous;
+  return vbyte_compress_sorted64(in, end, previous, length);
+}
+
+size_t
+vbyte_append_unsorted32(uint8_t *end, uint32_t value)
+{
+  return vbyte::write_int(end, value);
 }
 
 size_t
@@ -677,3 +2445,23 @@ vbyte_append_unsorted64(uint8_t *end, uint64_t value)
 {
   return vbyte::write_int(end, value);
 }
+
+size_t
+vbyte_count(const uint8_t *in, size_t size)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    return simd->count(in, (uint64_t)size);
+#endif
+  return vbyte::count(in, size);
+}
+
+size_t
+vbyte_locate(const uint8_t *in, size_t size, size_t index)
+{
+#if defined(USE_MASKEDVBYTE)
+  if (const masked_vbyte_kernels *simd = vbyte::masked_vbyte())
+    return simd->locate(in, (uint64_t)size, index);
+#endif
+  return vbyte::locate(in, size, index);
+}
@@ -36,8 +36,9 @@ extern "C" {
  * Calculates the size (in bytes) of a compressed stream of sorted 32bit
  * integers.
  *
- * This calculation is relatively expensive. As a cheap estimate, simply
- * multiply the number of integers by 5.
+ * The calculation is vectorized if the CPU supports SSE4.1, and then costs
+ * only a fraction of the compression. Otherwise it is relatively expensive;
+ * as a cheap estimate, simply multiply the number of integers by 5.
  *
  * This function uses delta encoding. Set |previous| to the initial value,
  * or 0.
@@ -50,8 +51,9 @@ vbyte_compressed_size_sorted32(const uint32_t *in, size_t length,
  * Calculates the size (in bytes) of a compressed stream of sorted 64bit
  * integers.
  *
- * This calculation is relatively expensive. As a cheap estimate, simply
- * multiply the number of integers by 5.
+ * The calculation is vectorized if the CPU supports SSE4.1, and then costs
+ * only a fraction of the compression. Otherwise it is relatively expensive;
+ * as a cheap estimate, simply multiply the number of integers by 5.
  *
  * This function uses delta encoding. Set |previous| to the initial value,
  * or 0.
@@ -64,8 +66,9 @@ vbyte_compressed_size_sorted64(const uint64_t *in, size_t length,
  * Calculates the size (in bytes) of a compressed stream of unsorted 32bit
  * integers.
  *
- * This calculation is relatively expensive. As a cheap estimate, simply
- * multiply the number of integers by 5.
+ * The calculation is vectorized if the CPU supports SSE4.1, and then costs
+ * only a fraction of the compression. Otherwise it is relatively expensive;
+ * as a cheap estimate, simply multiply the number of integers by 5.
  *
  * This function does NOT use delta encoding.
  */
@@ -76,8 +79,9 @@ vbyte_compressed_size_unsorted32(const uint32_t *in, size_t length);
  * Calculates the size (in bytes) of a compressed stream of unsorted 64bit
  * integers.
  *
- * This calculation is relatively expensive. As a cheap estimate, simply
- * multiply the number of integers by 10.
+ * The calculation is vectorized if the CPU supports SSE4.1, and then costs
+ * only a fraction of the compression. Otherwise it is relatively expensive;
+ * as a cheap estimate, simply multiply the number of integers by 10.
  *
  * This function does NOT use delta encoding.
  */
@@ -124,6 +128,62 @@ extern size_t
 vbyte_compress_sorted64(const uint64_t *in, uint8_t *out, uint64_t previous,
                 size_t length);
 
+/**
+ * Compresses as many integers of an unsorted sequence of |length| 32bit
+ * unsigned integers at |in| as fit into the |capacity| bytes at |out|.
+ * The number of compressed integers is stored in |*consumed|.
+ *
+ * This function does NOT use delta encoding.
+ *
+ * Returns the number of bytes written to |out|.
+ */
+extern size_t
+vbyte_compress_unsorted32_bounded(const uint32_t *in, size_t length,
+                uint8_t *out, size_t capacity, size_t *consumed);
+
+/**
+ * Compresses as many integers of an unsorted sequence of |length| 64bit
+ * unsigned integers at |in| as fit into the |capacity| bytes at |out|.
+ * The number of compressed integers is stored in |*consumed|.
+ *
+ * This function does NOT use delta encoding.
+ *
+ * Returns the number of bytes written to |out|.
+ */
+extern size_t
+vbyte_compress_unsorted64_bounded(const uint64_t *in, size_t length,
+                uint8_t *out, size_t capacity, size_t *consumed);
+
+/**
+ * Compresses as many integers of a sorted sequence of |length| 32bit
+ * unsigned integers at |in| as fit into the |capacity| bytes at |out|.
+ * The number of compressed integers is stored in |*consumed|.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * Returns the number of bytes written to |out|.
+ */
+extern size_t
+vbyte_compress_sorted32_bounded(const uint32_t *in, size_t length,
+                uint8_t *out, size_t capacity, uint32_t previous,
+                size_t *consumed);
+
+/**
+ * Compresses as many integers of a sorted sequence of |length| 64bit
+ * unsigned integers at |in| as fit into the |capacity| bytes at |out|.
+ * The number of compressed integers is stored in |*consumed|.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * Returns the number of bytes written to |out|.
+ */
+extern size_t
+vbyte_compress_sorted64_bounded(const uint64_t *in, size_t length,
+                uint8_t *out, size_t capacity, uint64_t previous,
+                size_t *consumed);
+
 /**
  * Uncompresses a sequence of |length| 32bit unsigned integers at |in|
  * and stores the result in |out|.
@@ -176,6 +236,120 @@ extern size_t
 vbyte_uncompress_sorted64(const uint8_t *in, uint64_t *out, uint64_t previous,
                 size_t length);
 
+/**
+ * Uncompresses the 32bit unsigned integers in the |size| bytes at |in|
+ * and stores the result in |out|.
+ *
+ * This is the equivalent of |vbyte_compress_unsorted32|. It does NOT use
+ * delta encoding.
+ *
+ * Returns the number of integers stored in |out|.
+ */
+extern size_t
+vbyte_uncompress_unsorted32_bytes(const uint8_t *in, size_t size,
+                uint32_t *out);
+
+/**
+ * Uncompresses the 64bit unsigned integers in the |size| bytes at |in|
+ * and stores the result in |out|.
+ *
+ * This is the equivalent of |vbyte_compress_unsorted64|. It does NOT use
+ * delta encoding.
+ *
+ * Returns the number of integers stored in |out|.
+ */
+extern size_t
+vbyte_uncompress_unsorted64_bytes(const uint8_t *in, size_t size,
+                uint64_t *out);
+
+/**
+ * Uncompresses the 32bit unsigned integers in the |size| bytes at |in|
+ * and stores the result in |out|.
+ *
+ * This is the equivalent of |vbyte_compress_sorted32|.
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * Returns the number of integers stored in |out|.
+ */
+extern size_t
+vbyte_uncompress_sorted32_bytes(const uint8_t *in, size_t size,
+                uint32_t *out, uint32_t previous);
+
+/**
+ * Uncompresses the 64bit unsigned integers in the |size| bytes at |in|
+ * and stores the result in |out|.
+ *
+ * This is the equivalent of |vbyte_compress_sorted64|.
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * Returns the number of integers stored in |out|.
+ */
+extern size_t
+vbyte_uncompress_sorted64_bytes(const uint8_t *in, size_t size,
+                uint64_t *out, uint64_t previous);
+
+/**
+ * Uncompresses the 32bit unsigned integers with the indices [|begin|, |end|)
+ * of a compressed sequence and stores them in |out|. The integers before
+ * |begin| are skipped by counting their terminating bytes.
+ *
+ * |size| is the size of the byte array pointed to by |in|.
+ *
+ * Returns the number of bytes read from |in|, which is the offset of the
+ * integer at |end|.
+ */
+extern size_t
+vbyte_uncompress_range_unsorted32(const uint8_t *in, size_t size,
+                size_t begin, size_t end, uint32_t *out);
+
+/**
+ * Uncompresses the 64bit unsigned integers with the indices [|begin|, |end|)
+ * of a compressed sequence and stores them in |out|. The integers before
+ * |begin| are skipped by counting their terminating bytes.
+ *
+ * |size| is the size of the byte array pointed to by |in|.
+ *
+ * Returns the number of bytes read from |in|, which is the offset of the
+ * integer at |end|.
+ */
+extern size_t
+vbyte_uncompress_range_unsorted64(const uint8_t *in, size_t size,
+                size_t begin, size_t end, uint64_t *out);
+
+/**
+ * Uncompresses the 32bit unsigned integers with the indices [|begin|, |end|)
+ * of a compressed sequence and stores them in |out|. The deltas before
+ * |begin| are summed up, but not prefix-summed.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ * |size| is the size of the byte array pointed to by |in|.
+ *
+ * Returns the number of bytes read from |in|, which is the offset of the
+ * integer at |end|.
+ */
+extern size_t
+vbyte_uncompress_range_sorted32(const uint8_t *in, size_t size,
+                uint32_t previous, size_t begin, size_t end, uint32_t *out);
+
+/**
+ * Uncompresses the 64bit unsigned integers with the indices [|begin|, |end|)
+ * of a compressed sequence and stores them in |out|. The deltas before
+ * |begin| are summed up, but not prefix-summed.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ * |size| is the size of the byte array pointed to by |in|.
+ *
+ * Returns the number of bytes read from |in|, which is the offset of the
+ * integer at |end|.
+ */
+extern size_t
+vbyte_uncompress_range_sorted64(const uint8_t *in, size_t size,
+                uint64_t previous, size_t begin, size_t end, uint64_t *out);
+
 /**
  * Returns the value at the given |index| from a sequence of compressed
  * 32bit integers.
@@ -228,6 +402,145 @@ vbyte_select_unsorted32(const uint8_t *in, size_t size, size_t index);
 extern uint64_t
 vbyte_select_unsorted64(const uint8_t *in, size_t size, size_t index);
 
+/**
+ * Stores the values at the given |indices| from a sequence of compressed
+ * 32bit integers in |out|. All values are selected in a single pass.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * |size| is the size of the byte array pointed to by |in|.
+ * |indices| is an array of |count| indices in ascending order; |out| must
+ * have room for |count| values. Make sure that the indices do not exceed
+ * the length of the sequence.
+ */
+extern void
+vbyte_select_many_sorted32(const uint8_t *in, size_t size, uint32_t previous,
+                const size_t *indices, size_t count, uint32_t *out);
+
+/**
+ * Stores the values at the given |indices| from a sequence of compressed
+ * 64bit integers in |out|. All values are selected in a single pass.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * |size| is the size of the byte array pointed to by |in|.
+ * |indices| is an array of |count| indices in ascending order; |out| must
+ * have room for |count| values. Make sure that the indices do not exceed
+ * the length of the sequence.
+ */
+extern void
+vbyte_select_many_sorted64(const uint8_t *in, size_t size, uint64_t previous,
+                const size_t *indices, size_t count, uint64_t *out);
+
+/**
+ * Stores the values at the given |indices| from a sequence of compressed
+ * 32bit integers in |out|. All values are selected in a single pass.
+ *
+ * This routine does NOT use delta compression.
+ *
+ * |size| is the size of the byte array pointed to by |in|.
+ * |indices| is an array of |count| indices in ascending order; |out| must
+ * have room for |count| values. Make sure that the indices do not exceed
+ * the length of the sequence.
+ */
+extern void
+vbyte_select_many_unsorted32(const uint8_t *in, size_t size,
+                const size_t *indices, size_t count, uint32_t *out);
+
+/**
+ * Stores the values at the given |indices| from a sequence of compressed
+ * 64bit integers in |out|. All values are selected in a single pass.
+ *
+ * This routine does NOT use delta compression.
+ *
+ * |size| is the size of the byte array pointed to by |in|.
+ * |indices| is an array of |count| indices in ascending order; |out| must
+ * have room for |count| values. Make sure that the indices do not exceed
+ * the length of the sequence.
+ */
+extern void
+vbyte_select_many_unsorted64(const uint8_t *in, size_t size,
+                const size_t *indices, size_t count, uint64_t *out);
+
+/**
+ * A sample of a skip index for a sequence of compressed 32bit integers.
+ * |offset| is the byte offset of the sampled integer, |previous| is the
+ * value of the integer in front of it (or the initial value).
+ */
+typedef struct vbyte_sample32 {
+  size_t offset;
+  uint32_t previous;
+} vbyte_sample32;
+
+/**
+ * A sample of a skip index for a sequence of compressed 64bit integers.
+ * See |vbyte_sample32|.
+ */
+typedef struct vbyte_sample64 {
+  size_t offset;
+  uint64_t previous;
+} vbyte_sample64;
+
+/**
+ * Builds a skip index for a sequence of |length| compressed 32bit integers,
+ * with a sample for every |interval|th integer. |samples| must have room
+ * for (|length| + |interval| - 1) / |interval| entries.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * Returns the number of samples stored in |samples|.
+ */
+extern size_t
+vbyte_build_index_sorted32(const uint8_t *in, size_t length,
+                uint32_t previous, size_t interval, vbyte_sample32 *samples);
+
+/**
+ * Builds a skip index for a sequence of |length| compressed 64bit integers,
+ * with a sample for every |interval|th integer. |samples| must have room
+ * for (|length| + |interval| - 1) / |interval| entries.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * Returns the number of samples stored in |samples|.
+ */
+extern size_t
+vbyte_build_index_sorted64(const uint8_t *in, size_t length,
+                uint64_t previous, size_t interval, vbyte_sample64 *samples);
+
+/**
+ * Returns the value at the given |index| from a sequence of compressed
+ * 32bit integers. Jumps to the nearest sample of the skip index built with
+ * |vbyte_build_index_sorted32|, and only decodes the integers following it.
+ *
+ * This function uses delta encoding.
+ *
+ * |size| is the size of the byte array pointed to by |in|.
+ * Make sure that |index| does not exceed the length of the sequence, and
+ * that |interval| is the same as when the index was built.
+ */
+extern uint32_t
+vbyte_select_sorted_indexed32(const uint8_t *in, size_t size,
+                const vbyte_sample32 *samples, size_t interval, size_t index);
+
+/**
+ * Returns the value at the given |index| from a sequence of compressed
+ * 64bit integers. Jumps to the nearest sample of the skip index built with
+ * |vbyte_build_index_sorted64|, and only decodes the integers following it.
+ *
+ * This function uses delta encoding.
+ *
+ * |size| is the size of the byte array pointed to by |in|.
+ * Make sure that |index| does not exceed the length of the sequence, and
+ * that |interval| is the same as when the index was built.
+ */
+extern uint64_t
+vbyte_select_sorted_indexed64(const uint8_t *in, size_t size,
+                const vbyte_sample64 *samples, size_t interval, size_t index);
+
 
 /**
  * Performs a linear search for |value| in a sequence of compressed 32bit
@@ -255,96 +568,936 @@ vbyte_search_unsorted64(const uint8_t *in, size_t length, uint64_t value);
 
 
 /**
- * Performs a lower-bound search for |value| in a sequence of compressed 32bit
- * unsigned integers.
+ * A cursor for iterating over a sequence of compressed 32bit integers with
+ * delta encoding. The integers are decoded in groups of up to 16 into
+ * |buffer|.
  *
- * A lower bound search returns the first element in the sequence which does
- * not compare less than |value|.
- * The actual result is stored in |*actual|.
+ * Use |vbyte_cursor_init32| to initialize the cursor; the fields are
+ * private.
+ */
+typedef struct vbyte_cursor32 {
+  const uint8_t *in;
+  size_t length;
+  size_t index;
+  size_t consumed;
+  size_t decoded;
+  const vbyte_sample32 *samples;
+  size_t interval;
+  uint32_t previous;
+  uint32_t position;
+  uint32_t buffered;
+  uint32_t buffer[16];
+} vbyte_cursor32;
+
+/**
+ * A cursor for iterating over a sequence of compressed 64bit integers with
+ * delta encoding. See |vbyte_cursor32|.
+ */
+typedef struct vbyte_cursor64 {
+  const uint8_t *in;
+  size_t length;
+  size_t index;
+  size_t consumed;
+  size_t decoded;
+  const vbyte_sample64 *samples;
+  size_t interval;
+  uint64_t previous;
+  uint32_t position;
+  uint32_t buffered;
+  uint64_t buffer[16];
+} vbyte_cursor64;
+
+/**
+ * Initializes a |cursor| for a sequence of |length| compressed 32bit
+ * integers, and moves it to the first integer.
  *
  * This function uses delta encoding. Set |previous| to the initial value,
  * or 0.
  *
- * Returns the index of the found element, or |length| if the key was not
- * found.
+ * |samples| is an optional skip index built with
+ * |vbyte_build_index_sorted32| with the given |interval|; if it is not NULL
+ * then |vbyte_cursor_skip_to32| gallops over the samples.
  */
-extern size_t
-vbyte_search_lower_bound_sorted32(const uint8_t *in, size_t length,
-                uint32_t value, uint32_t previous, uint32_t *actual);
+extern void
+vbyte_cursor_init32(vbyte_cursor32 *cursor, const uint8_t *in, size_t length,
+                uint32_t previous, const vbyte_sample32 *samples,
+                size_t interval);
 
 /**
- * Performs a lower-bound search for |value| in a sequence of compressed 64bit
- * unsigned integers.
- *
- * A lower bound search returns the first element in the sequence which does
- * not compare less than |value|.
- * The actual result is stored in |*actual|.
+ * Initializes a |cursor| for a sequence of |length| compressed 64bit
+ * integers, and moves it to the first integer.
  *
  * This function uses delta encoding. Set |previous| to the initial value,
  * or 0.
  *
- * Returns the index of the found element, or |length| if the key was not
- * found.
+ * |samples| is an optional skip index built with
+ * |vbyte_build_index_sorted64| with the given |interval|; if it is not NULL
+ * then |vbyte_cursor_skip_to64| gallops over the samples.
  */
-extern size_t
-vbyte_search_lower_bound_sorted64(const uint8_t *in, size_t length,
-                uint64_t value, uint64_t previous, uint64_t *actual);
+extern void
+vbyte_cursor_init64(vbyte_cursor64 *cursor, const uint8_t *in, size_t length,
+                uint64_t previous, const vbyte_sample64 *samples,
+                size_t interval);
 
+/**
+ * Moves the |cursor| to the next integer.
+ *
+ * Returns 1, or 0 if the cursor moved past the end of the sequence.
+ */
+extern int
+vbyte_cursor_next32(vbyte_cursor32 *cursor);
 
 /**
- * Appends |value| to a sequence of compressed 32bit unsigned integers.
+ * Moves the |cursor| to the next integer.
  *
- * |end| is a pointer to the end of the compressed sequence (the first byte
- * AFTER the compressed data).
- * |previous| is the greatest encoded value in the sequence.
+ * Returns 1, or 0 if the cursor moved past the end of the sequence.
+ */
+extern int
+vbyte_cursor_next64(vbyte_cursor64 *cursor);
+
+/**
+ * Moves the |cursor| forward to the first integer which does not compare
+ * less than |value|. The cursor never moves backwards.
  *
- * This function uses delta encoding.
+ * With a skip index the cursor gallops over the samples and then decodes
+ * at most one block. Without a skip index every integer up to |value| is
+ * decoded, since each delta is needed for the next value; a long skip
+ * then costs as much as a linear scan.
  *
- * Returns the number of bytes required to compress |value|.
+ * Returns 1, or 0 if the cursor moved past the end of the sequence.
  */
-extern size_t
-vbyte_append_sorted32(uint8_t *end, uint32_t previous, uint32_t value);
+extern int
+vbyte_cursor_skip_to32(vbyte_cursor32 *cursor, uint32_t value);
 
 /**
- * Appends |value| to a sequence of compressed 64bit unsigned integers.
- *
- * |end| is a pointer to the end of the compressed sequence (the first byte
- * AFTER the compressed data).
- * |previous| is the greatest encoded value in the sequence.
+ * Moves the |cursor| forward to the first integer which does not compare
+ * less than |value|. The cursor never moves backwards.
  *
- * This function uses delta encoding.
+ * With a skip index the cursor gallops over the samples and then decodes
+ * at most one block. Without a skip index every integer up to |value| is
+ * decoded, since each delta is needed for the next value; a long skip
+ * then costs as much as a linear scan.
  *
- * Returns the number of bytes required to compress |value|.
+ * Returns 1, or 0 if the cursor moved past the end of the sequence.
+ */
+extern int
+vbyte_cursor_skip_to64(vbyte_cursor64 *cursor, uint64_t value);
+
+/**
+ * Returns the integer at the current position of the |cursor|. Make sure
+ * that the cursor did not move past the end of the sequence.
+ */
+extern uint32_t
+vbyte_cursor_current32(const vbyte_cursor32 *cursor);
+
+/**
+ * Returns the integer at the current position of the |cursor|. Make sure
+ * that the cursor did not move past the end of the sequence.
+ */
+extern uint64_t
+vbyte_cursor_current64(const vbyte_cursor64 *cursor);
+
+/**
+ * Returns the index of the current position of the |cursor|, or the length
+ * of the sequence if the cursor moved past its end.
  */
 extern size_t
-vbyte_append_sorted64(uint8_t *end, uint64_t previous, uint64_t value);
+vbyte_cursor_index32(const vbyte_cursor32 *cursor);
 
 /**
- * Appends |value| to a sequence of compressed 32bit unsigned integers.
+ * Returns the index of the current position of the |cursor|, or the length
+ * of the sequence if the cursor moved past its end.
+ */
+extern size_t
+vbyte_cursor_index64(const vbyte_cursor64 *cursor);
+
+/**
+ * A cursor for iterating backwards over a sequence of compressed 32bit
+ * integers with delta encoding. Every step subtracts the delta of the
+ * current integer, therefore only the last value has to be computed
+ * in advance, or be known by the caller.
  *
- * |end| is a pointer to the end of the compressed sequence (the first byte
- * AFTER the compressed data).
+ * Use |vbyte_reverse_cursor_init32| to initialize the cursor; the fields are
+ * private.
+ */
+typedef struct vbyte_reverse_cursor32 {
+  const uint8_t *in;
+  size_t offset;
+  size_t index;
+  uint32_t current;
+  uint32_t delta;
+} vbyte_reverse_cursor32;
+
+/**
+ * A cursor for iterating backwards over a sequence of compressed 64bit
+ * integers with delta encoding. See |vbyte_reverse_cursor32|.
+ */
+typedef struct vbyte_reverse_cursor64 {
+  const uint8_t *in;
+  size_t offset;
+  size_t index;
+  uint64_t current;
+  uint64_t delta;
+} vbyte_reverse_cursor64;
+
+/**
+ * Initializes a |cursor| for the compressed 32bit integers in the |size|
+ * bytes at |in|, and moves it to the last integer.
  *
- * This function does NOT use encoding.
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
  *
- * Returns the number of bytes required to compress |value|.
+ * Returns 1, or 0 if the sequence is empty.
  */
-extern size_t
-vbyte_append_unsorted32(uint8_t *end, uint32_t value);
+extern int
+vbyte_reverse_cursor_init32(vbyte_reverse_cursor32 *cursor, const uint8_t *in,
+                size_t size, uint32_t previous);
 
 /**
- * Appends |value| to a sequence of compressed 64bit unsigned integers.
- *
- * |end| is a pointer to the end of the compressed sequence (the first byte
- * AFTER the compressed data).
+ * Initializes a |cursor| for the |length| compressed 32bit integers in the
+ * |size| bytes at |in|, and moves it to the last integer, whose value is
+ * |last|.
  *
- * This function does NOT use encoding.
+ * |vbyte_reverse_cursor_init32| decodes the whole sequence to find the last
+ * value. Callers which keep the last value and the length of a sequence
+ * anyway (i.e. to append to it) start here in constant time instead.
  *
- * Returns the number of bytes required to compress |value|.
+ * Returns 1, or 0 if the sequence is empty.
  */
-extern size_t
+extern int
+vbyte_reverse_cursor_init_last32(vbyte_reverse_cursor32 *cursor,
+                const uint8_t *in, size_t size, size_t length, uint32_t last);
+
+/**
+ * Initializes a |cursor| for the compressed 64bit integers in the |size|
+ * bytes at |in|, and moves it to the last integer.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * Returns 1, or 0 if the sequence is empty.
+ */
+extern int
+vbyte_reverse_cursor_init64(vbyte_reverse_cursor64 *cursor, const uint8_t *in,
+                size_t size, uint64_t previous);
+
+/**
+ * Initializes a |cursor| for the |length| compressed 64bit integers in the
+ * |size| bytes at |in|, and moves it to the last integer, whose value is
+ * |last|.
+ *
+ * |vbyte_reverse_cursor_init64| decodes the whole sequence to find the last
+ * value. Callers which keep the last value and the length of a sequence
+ * anyway (i.e. to append to it) start here in constant time instead.
+ *
+ * Returns 1, or 0 if the sequence is empty.
+ */
+extern int
+vbyte_reverse_cursor_init_last64(vbyte_reverse_cursor64 *cursor,
+                const uint8_t *in, size_t size, size_t length, uint64_t last);
+
+/**
+ * Moves the |cursor| to the previous integer.
+ *
+ * Returns 1, or 0 if the cursor already is at the first integer; the cursor
+ * then stays on the first integer.
+ */
+extern int
+vbyte_reverse_cursor_prev32(vbyte_reverse_cursor32 *cursor);
+
+/**
+ * Moves the |cursor| to the previous integer.
+ *
+ * Returns 1, or 0 if the cursor already is at the first integer; the cursor
+ * then stays on the first integer.
+ */
+extern int
+vbyte_reverse_cursor_prev64(vbyte_reverse_cursor64 *cursor);
+
+/**
+ * Returns the integer at the current position of the |cursor|. Make sure
+ * that the cursor did not move past the beginning of the sequence.
+ */
+extern uint32_t
+vbyte_reverse_cursor_current32(const vbyte_reverse_cursor32 *cursor);
+
+/**
+ * Returns the integer at the current position of the |cursor|. Make sure
+ * that the cursor did not move past the beginning of the sequence.
+ */
+extern uint64_t
+vbyte_reverse_cursor_current64(const vbyte_reverse_cursor64 *cursor);
+
+/**
+ * Returns the index of the current position of the |cursor|.
+ */
+extern size_t
+vbyte_reverse_cursor_index32(const vbyte_reverse_cursor32 *cursor);
+
+/**
+ * Returns the index of the current position of the |cursor|.
+ */
+extern size_t
+vbyte_reverse_cursor_index64(const vbyte_reverse_cursor64 *cursor);
+
+/**
+ * Performs a lower-bound search for |value| in a sequence of compressed 32bit
+ * unsigned integers.
+ *
+ * A lower bound search returns the first element in the sequence which does
+ * not compare less than |value|.
+ * The actual result is stored in |*actual|. If every element compares less
+ * than |value| then the last element (or |previous|, if the sequence is
+ * empty) is stored instead.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * Returns the index of the found element, or |length| if the key was not
+ * found.
+ */
+extern size_t
+vbyte_search_lower_bound_sorted32(const uint8_t *in, size_t length,
+                uint32_t value, uint32_t previous, uint32_t *actual);
+
+/**
+ * Performs a lower-bound search for |value| in a sequence of compressed 64bit
+ * unsigned integers.
+ *
+ * A lower bound search returns the first element in the sequence which does
+ * not compare less than |value|.
+ * The actual result is stored in |*actual|. If every element compares less
+ * than |value| then the last element (or |previous|, if the sequence is
+ * empty) is stored instead.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * Returns the index of the found element, or |length| if the key was not
+ * found.
+ */
+extern size_t
+vbyte_search_lower_bound_sorted64(const uint8_t *in, size_t length,
+                uint64_t value, uint64_t previous, uint64_t *actual);
+
+/**
+ * Performs a lower-bound search for each of the |count| |values| in a
+ * sequence of |length| compressed 32bit unsigned integers. The |values|
+ * must be in ascending order; they are all searched in a single pass.
+ *
+ * The index of each found element is stored in |positions|, or |length| if
+ * the key was not found. The actual results are stored in |actual|.
+ * Both arrays must have room for |count| elements.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ */
+extern void
+vbyte_search_lower_bound_many_sorted32(const uint8_t *in, size_t length,
+                uint32_t previous, const uint32_t *values, size_t count,
+                size_t *positions, uint32_t *actual);
+
+/**
+ * Performs a lower-bound search for each of the |count| |values| in a
+ * sequence of |length| compressed 64bit unsigned integers. The |values|
+ * must be in ascending order; they are all searched in a single pass.
+ *
+ * The index of each found element is stored in |positions|, or |length| if
+ * the key was not found. The actual results are stored in |actual|.
+ * Both arrays must have room for |count| elements.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ */
+extern void
+vbyte_search_lower_bound_many_sorted64(const uint8_t *in, size_t length,
+                uint64_t previous, const uint64_t *values, size_t count,
+                size_t *positions, uint64_t *actual);
+
+/**
+ * Returns the number of integers in the range [|low|, |high|) in a sequence
+ * of |length| compressed 32bit unsigned integers. Both ends of the range
+ * are found in a single pass, which stops after |high|.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ */
+extern size_t
+vbyte_count_range_sorted32(const uint8_t *in, size_t length,
+                uint32_t previous, uint32_t low, uint32_t high);
+
+/**
+ * Returns the number of integers in the range [|low|, |high|) in a sequence
+ * of |length| compressed 64bit unsigned integers. Both ends of the range
+ * are found in a single pass, which stops after |high|.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ */
+extern size_t
+vbyte_count_range_sorted64(const uint8_t *in, size_t length,
+                uint64_t previous, uint64_t low, uint64_t high);
+
+/**
+ * Performs a lower-bound search for |value| in a sequence of |length|
+ * compressed 32bit unsigned integers.
+ *
+ * Uses a binary search over the skip index built with
+ * |vbyte_build_index_sorted32|, and then only scans the integers between
+ * two samples. Make sure that |interval| is the same as when the index was
+ * built.
+ *
+ * The actual result is stored in |*actual|.
+ *
+ * This function uses delta encoding.
+ *
+ * Returns the index of the found element, or |length| if the key was not
+ * found.
+ */
+extern size_t
+vbyte_search_lower_bound_sorted_indexed32(const uint8_t *in, size_t length,
+                const vbyte_sample32 *samples, size_t interval, uint32_t value,
+                uint32_t *actual);
+
+/**
+ * Performs a lower-bound search for |value| in a sequence of |length|
+ * compressed 64bit unsigned integers.
+ *
+ * Uses a binary search over the skip index built with
+ * |vbyte_build_index_sorted64|, and then only scans the integers between
+ * two samples. Make sure that |interval| is the same as when the index was
+ * built.
+ *
+ * The actual result is stored in |*actual|.
+ *
+ * This function uses delta encoding.
+ *
+ * Returns the index of the found element, or |length| if the key was not
+ * found.
+ */
+extern size_t
+vbyte_search_lower_bound_sorted_indexed64(const uint8_t *in, size_t length,
+                const vbyte_sample64 *samples, size_t interval, uint64_t value,
+                uint64_t *actual);
+
+
+/**
+ * Intersects two sequences of compressed 32bit unsigned integers with
+ * |length1| and |length2| integers. Both sequences are decoded in chunks;
+ * the chunks are intersected with SSE, if available.
+ *
+ * This function uses delta encoding. Set |previous1| and |previous2| to the
+ * initial values the sequences were compressed with, or 0. The integers of
+ * both sequences must be strictly increasing.
+ *
+ * |out| must have room for the integers of the shorter sequence.
+ *
+ * Returns the number of integers stored in |out|.
+ */
+extern size_t
+vbyte_intersect_sorted32(const uint8_t *in1, size_t length1,
+                uint32_t previous1, const uint8_t *in2, size_t length2,
+                uint32_t previous2, uint32_t *out);
+
+/**
+ * Intersects two sequences of compressed 64bit unsigned integers with
+ * |length1| and |length2| integers. Both sequences are decoded in chunks;
+ * the chunks are intersected with SSE, if available.
+ *
+ * This function uses delta encoding. Set |previous1| and |previous2| to the
+ * initial values the sequences were compressed with, or 0. The integers of
+ * both sequences must be strictly increasing.
+ *
+ * |out| must have room for the integers of the shorter sequence.
+ *
+ * Returns the number of integers stored in |out|.
+ */
+extern size_t
+vbyte_intersect_sorted64(const uint8_t *in1, size_t length1,
+                uint64_t previous1, const uint8_t *in2, size_t length2,
+                uint64_t previous2, uint64_t *out);
+
+/**
+ * The maximum number of sequences which can be merged with
+ * |vbyte_union_sorted32| and |vbyte_union_sorted64|. The inputs are decoded
+ * into buffers on the stack.
+ */
+#define VBYTE_UNION_MAX_INPUTS 16
+
+/**
+ * Merges |count| sequences of compressed 32bit unsigned integers into a
+ * single compressed sequence without duplicates. |inputs| and |lengths|
+ * are arrays with the compressed sequences and their number of integers;
+ * |count| must not be greater than VBYTE_UNION_MAX_INPUTS; merge more
+ * sequences in several rounds. The inputs are decoded and the output is
+ * compressed in chunks; they are never uncompressed as a whole.
+ *
+ * This function uses delta encoding. |previous| is an array with the
+ * initial values the inputs were compressed with (or 0); |out| is
+ * compressed with an initial value of 0.
+ *
+ * |out| must have room for the compressed sizes of all inputs combined,
+ * plus 4 bytes per input with a non-zero initial value.
+ * The number of integers in |out| is stored in |*length|.
+ *
+ * Returns the number of bytes written to |out|. If |count| is greater than
+ * VBYTE_UNION_MAX_INPUTS then nothing is written, |*length| is set to 0
+ * and (size_t)-1 is returned.
+ */
+extern size_t
+vbyte_union_sorted32(const uint8_t *const *inputs, const size_t *lengths,
+                const uint32_t *previous, size_t count, uint8_t *out,
+                size_t *length);
+
+/**
+ * Merges |count| sequences of compressed 64bit unsigned integers into a
+ * single compressed sequence without duplicates. |inputs| and |lengths|
+ * are arrays with the compressed sequences and their number of integers;
+ * |count| must not be greater than VBYTE_UNION_MAX_INPUTS; merge more
+ * sequences in several rounds. The inputs are decoded and the output is
+ * compressed in chunks; they are never uncompressed as a whole.
+ *
+ * This function uses delta encoding. |previous| is an array with the
+ * initial values the inputs were compressed with (or 0); |out| is
+ * compressed with an initial value of 0.
+ *
+ * |out| must have room for the compressed sizes of all inputs combined,
+ * plus 9 bytes per input with a non-zero initial value.
+ * The number of integers in |out| is stored in |*length|.
+ *
+ * Returns the number of bytes written to |out|. If |count| is greater than
+ * VBYTE_UNION_MAX_INPUTS then nothing is written, |*length| is set to 0
+ * and (size_t)-1 is returned.
+ */
+extern size_t
+vbyte_union_sorted64(const uint8_t *const *inputs, const size_t *lengths,
+                const uint64_t *previous, size_t count, uint8_t *out,
+                size_t *length);
+
+/**
+ * Stores the integers of a sequence of |length1| compressed 32bit unsigned
+ * integers which are NOT in a second sequence of |length2| compressed
+ * integers (the set difference) in |out|. Both sequences are decoded in
+ * chunks; the chunks are compared with SSE, if available.
+ *
+ * This function uses delta encoding. Set |previous1| and |previous2| to the
+ * initial values the sequences were compressed with, or 0. The integers of
+ * both sequences must be strictly increasing.
+ *
+ * |out| must have room for |length1| integers.
+ *
+ * Returns the number of integers stored in |out|.
+ */
+extern size_t
+vbyte_difference_sorted32(const uint8_t *in1, size_t length1,
+                uint32_t previous1, const uint8_t *in2, size_t length2,
+                uint32_t previous2, uint32_t *out);
+
+/**
+ * Stores the integers of a sequence of |length1| compressed 64bit unsigned
+ * integers which are NOT in a second sequence of |length2| compressed
+ * integers (the set difference) in |out|. Both sequences are decoded in
+ * chunks; the chunks are compared with SSE, if available.
+ *
+ * This function uses delta encoding. Set |previous1| and |previous2| to the
+ * initial values the sequences were compressed with, or 0. The integers of
+ * both sequences must be strictly increasing.
+ *
+ * |out| must have room for |length1| integers.
+ *
+ * Returns the number of integers stored in |out|.
+ */
+extern size_t
+vbyte_difference_sorted64(const uint8_t *in1, size_t length1,
+                uint64_t previous1, const uint8_t *in2, size_t length2,
+                uint64_t previous2, uint64_t *out);
+
+/**
+ * Like |vbyte_difference_sorted32|, but compresses the result (with delta
+ * encoding) instead of storing the integers. Set |previous| to the initial
+ * value for |out|, or 0; it must not be greater than |previous1|.
+ *
+ * |out| must have room for the compressed size of the first sequence, plus
+ * 4 bytes if |previous| is less than |previous1|.
+ * The number of integers in |out| is stored in |*length|.
+ *
+ * Returns the number of bytes written to |out|.
+ */
+extern size_t
+vbyte_difference_compressed_sorted32(const uint8_t *in1, size_t length1,
+                uint32_t previous1, const uint8_t *in2, size_t length2,
+                uint32_t previous2, uint8_t *out, uint32_t previous, size_t *length);
+
+/**
+ * Like |vbyte_difference_sorted64|, but compresses the result (with delta
+ * encoding) instead of storing the integers. Set |previous| to the initial
+ * value for |out|, or 0; it must not be greater than |previous1|.
+ *
+ * |out| must have room for the compressed size of the first sequence, plus
+ * 9 bytes if |previous| is less than |previous1|.
+ * The number of integers in |out| is stored in |*length|.
+ *
+ * Returns the number of bytes written to |out|.
+ */
+extern size_t
+vbyte_difference_compressed_sorted64(const uint8_t *in1, size_t length1,
+                uint64_t previous1, const uint8_t *in2, size_t length2,
+                uint64_t previous2, uint8_t *out, uint64_t previous, size_t *length);
+
+/**
+ * Returns the last (and greatest) value of the compressed 32bit unsigned
+ * integers in the |size| bytes at |in|, i.e. the |previous| argument of
+ * |vbyte_append_sorted32|.
+ *
+ * The format has no trailer, therefore all deltas are summed up and this
+ * function costs a full decode. Keep the last value next to the sequence
+ * if it is needed often; see |vbyte_reverse_cursor_init_last32|.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0. Returns |previous| if the sequence is empty.
+ */
+extern uint32_t
+vbyte_select_last_sorted32(const uint8_t *in, size_t size, uint32_t previous);
+
+/**
+ * Returns the last (and greatest) value of the compressed 64bit unsigned
+ * integers in the |size| bytes at |in|, i.e. the |previous| argument of
+ * |vbyte_append_sorted64|.
+ *
+ * The format has no trailer, therefore all deltas are summed up and this
+ * function costs a full decode. Keep the last value next to the sequence
+ * if it is needed often; see |vbyte_reverse_cursor_init_last64|.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0. Returns |previous| if the sequence is empty.
+ */
+extern uint64_t
+vbyte_select_last_sorted64(const uint8_t *in, size_t size, uint64_t previous);
+
+/**
+ * Uncompresses the last |length| 32bit unsigned integers in the |size| bytes
+ * at |in| and stores them in |out| in reverse order, i.e. the last integer
+ * is stored in |out[0]|. The integers are located by scanning backwards from
+ * the end of the sequence; nothing before them is read.
+ *
+ * The sequence must have at least |length| integers.
+ * This function does NOT use delta encoding.
+ *
+ * Returns the byte offset of the first uncompressed integer; use it as the
+ * new |size| to continue with the preceding integers.
+ */
+extern size_t
+vbyte_uncompress_reverse_unsorted32(const uint8_t *in, size_t size,
+                uint32_t *out, size_t length);
+
+/**
+ * Uncompresses the last |length| 64bit unsigned integers in the |size| bytes
+ * at |in| and stores them in |out| in reverse order, i.e. the last integer
+ * is stored in |out[0]|. The integers are located by scanning backwards from
+ * the end of the sequence; nothing before them is read.
+ *
+ * The sequence must have at least |length| integers.
+ * This function does NOT use delta encoding.
+ *
+ * Returns the byte offset of the first uncompressed integer; use it as the
+ * new |size| to continue with the preceding integers.
+ */
+extern size_t
+vbyte_uncompress_reverse_unsorted64(const uint8_t *in, size_t size,
+                uint64_t *out, size_t length);
+
+/**
+ * Inserts |value| into a sequence of |length| compressed 32bit unsigned
+ * integers, which occupies |size| bytes at |in|. The position is found
+ * with a lower-bound search; only the delta at this position is rewritten
+ * and the following bytes are moved. Appending a value costs a single
+ * search.
+ *
+ * The sequence must stay strictly increasing; |value| must not already be
+ * in the sequence.
+ *
+ * The buffer at |in| must have room for |size| + 5 bytes.
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * Returns the new size of the compressed sequence in bytes.
+ */
+extern size_t
+vbyte_insert_sorted32(uint8_t *in, size_t length, size_t size,
+                uint32_t previous, uint32_t value);
+
+/**
+ * Inserts |value| into a sequence of |length| compressed 64bit unsigned
+ * integers, which occupies |size| bytes at |in|. The position is found
+ * with a lower-bound search; only the delta at this position is rewritten
+ * and the following bytes are moved. Appending a value costs a single
+ * search.
+ *
+ * The sequence must stay strictly increasing; |value| must not already be
+ * in the sequence.
+ *
+ * The buffer at |in| must have room for |size| + 10 bytes.
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * Returns the new size of the compressed sequence in bytes.
+ */
+extern size_t
+vbyte_insert_sorted64(uint8_t *in, size_t length, size_t size,
+                uint64_t previous, uint64_t value);
+
+/**
+ * Removes the first occurrence of |value| from a sequence of |length|
+ * compressed 32bit unsigned integers, which occupies |size| bytes at |in|.
+ * The deltas of |value| and of its successor are merged and the following
+ * bytes are moved.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * Returns the new size of the compressed sequence in bytes; it is |size|
+ * if |value| was not found.
+ */
+extern size_t
+vbyte_erase_sorted32(uint8_t *in, size_t length, size_t size,
+                uint32_t previous, uint32_t value);
+
+/**
+ * Removes the first occurrence of |value| from a sequence of |length|
+ * compressed 64bit unsigned integers, which occupies |size| bytes at |in|.
+ * The deltas of |value| and of its successor are merged and the following
+ * bytes are moved.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0.
+ *
+ * Returns the new size of the compressed sequence in bytes; it is |size|
+ * if |value| was not found.
+ */
+extern size_t
+vbyte_erase_sorted64(uint8_t *in, size_t length, size_t size,
+                uint64_t previous, uint64_t value);
+
+/**
+ * Splits the compressed 32bit unsigned integers in the |size| bytes at |in|
+ * into two halves of about the same size in bytes. The left half is
+ * stored in |left|, the right half in |right|; their sizes are stored in
+ * |*left_size| and |*right_size|. Only the first integer of the right half
+ * is re-encoded, everything else is copied.
+ *
+ * The re-encoded integer needs the last value of the left half, therefore
+ * the left half is decoded; use |vbyte_split_sorted_indexed32| to avoid
+ * that.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0. The left half continues to use |previous|, the right half uses 0.
+ * |left| can be the same as |in|, but |right| must not overlap |in|.
+ *
+ * Returns the number of integers in the left half.
+ */
+extern size_t
+vbyte_split_sorted32(const uint8_t *in, size_t size, uint32_t previous,
+                uint8_t *left, size_t *left_size, uint8_t *right,
+                size_t *right_size);
+
+/**
+ * Like |vbyte_split_sorted32|, but jumps to the last sample of the skip
+ * index in front of the split point and only decodes the integers
+ * following it. |samples| is built with |vbyte_build_index_sorted32| with
+ * the given |interval| for the |length| integers of the sequence.
+ *
+ * Returns the number of integers in the left half.
+ */
+extern size_t
+vbyte_split_sorted_indexed32(const uint8_t *in, size_t size, size_t length,
+                const vbyte_sample32 *samples, size_t interval, uint8_t *left,
+                size_t *left_size, uint8_t *right, size_t *right_size);
+
+/**
+ * Splits the compressed 64bit unsigned integers in the |size| bytes at |in|
+ * into two halves of about the same size in bytes. The left half is
+ * stored in |left|, the right half in |right|; their sizes are stored in
+ * |*left_size| and |*right_size|. Only the first integer of the right half
+ * is re-encoded, everything else is copied.
+ *
+ * The re-encoded integer needs the last value of the left half, therefore
+ * the left half is decoded; use |vbyte_split_sorted_indexed64| to avoid
+ * that.
+ *
+ * This function uses delta encoding. Set |previous| to the initial value,
+ * or 0. The left half continues to use |previous|, the right half uses 0.
+ * |left| can be the same as |in|, but |right| must not overlap |in|.
+ *
+ * Returns the number of integers in the left half.
+ */
+extern size_t
+vbyte_split_sorted64(const uint8_t *in, size_t size, uint64_t previous,
+                uint8_t *left, size_t *left_size, uint8_t *right,
+                size_t *right_size);
+
+/**
+ * Like |vbyte_split_sorted64|, but jumps to the last sample of the skip
+ * index in front of the split point and only decodes the integers
+ * following it. |samples| is built with |vbyte_build_index_sorted64| with
+ * the given |interval| for the |length| integers of the sequence.
+ *
+ * Returns the number of integers in the left half.
+ */
+extern size_t
+vbyte_split_sorted_indexed64(const uint8_t *in, size_t size, size_t length,
+                const vbyte_sample64 *samples, size_t interval, uint8_t *left,
+                size_t *left_size, uint8_t *right, size_t *right_size);
+
+/**
+ * Concatenates two sequences of compressed 32bit unsigned integers, the
+ * |size1| bytes at |in1| and the |size2| bytes at |in2|, and stores the
+ * result in |out|. Only the first integer of |in2| is re-encoded, everything
+ * else is copied. This is the reverse of |vbyte_split_sorted32|.
+ *
+ * |last| is the last value of |in1| (or its initial value, if |in1| is
+ * empty); |previous| is the initial value of |in2|. The first value of
+ * |in2| must not compare less than |last|.
+ * |out| can be the same as |in1|, but must not overlap |in2|.
+ *
+ * Returns the number of bytes written to |out|.
+ */
+extern size_t
+vbyte_concat_sorted32(const uint8_t *in1, size_t size1, uint32_t last,
+                const uint8_t *in2, size_t size2, uint32_t previous,
+                uint8_t *out);
+
+/**
+ * Concatenates two sequences of compressed 64bit unsigned integers, the
+ * |size1| bytes at |in1| and the |size2| bytes at |in2|, and stores the
+ * result in |out|. Only the first integer of |in2| is re-encoded, everything
+ * else is copied. This is the reverse of |vbyte_split_sorted64|.
+ *
+ * |last| is the last value of |in1| (or its initial value, if |in1| is
+ * empty); |previous| is the initial value of |in2|. The first value of
+ * |in2| must not compare less than |last|.
+ * |out| can be the same as |in1|, but must not overlap |in2|.
+ *
+ * Returns the number of bytes written to |out|.
+ */
+extern size_t
+vbyte_concat_sorted64(const uint8_t *in1, size_t size1, uint64_t last,
+                const uint8_t *in2, size_t size2, uint64_t previous,
+                uint8_t *out);
+
+/**
+ * Appends |value| to a sequence of compressed 32bit unsigned integers.
+ *
+ * |end| is a pointer to the end of the compressed sequence (the first byte
+ * AFTER the compressed data).
+ * |previous| is the greatest encoded value in the sequence.
+ *
+ * This function uses delta encoding.
+ *
+ * Returns the number of bytes required to compress |value|.
+ */
+extern size_t
+vbyte_append_sorted32(uint8_t *end, uint32_t previous, uint32_t value);
+
+/**
+ * Appends |value| to a sequence of compressed 64bit unsigned integers.
+ *
+ * |end| is a pointer to the end of the compressed sequence (the first byte
+ * AFTER the compressed data).
+ * |previous| is the greatest encoded value in the sequence.
+ *
+ * This function uses delta encoding.
+ *
+ * Returns the number of bytes required to compress |value|.
+ */
+extern size_t
+vbyte_append_sorted64(uint8_t *end, uint64_t previous, uint64_t value);
+
+/**
+ * Appends the |length| sorted 32bit unsigned integers in |in| to a sequence
+ * of compressed integers, with the vectorized encoder.
+ *
+ * |end| is a pointer to the end of the compressed sequence (the first byte
+ * AFTER the compressed data).
+ * |previous| is the greatest encoded value in the sequence. The new greatest
+ * value is stored in |*last|.
+ *
+ * As with |vbyte_append_sorted32|, the integers must be strictly increasing
+ * and greater than |previous|.
+ *
+ * This function uses delta encoding.
+ *
+ * Returns the number of bytes written to |end|.
+ */
+extern size_t
+vbyte_append_many_sorted32(uint8_t *end, uint32_t previous,
+                const uint32_t *in, size_t length, uint32_t *last);
+
+/**
+ * Appends the |length| sorted 64bit unsigned integers in |in| to a sequence
+ * of compressed integers, with the vectorized encoder.
+ *
+ * |end| is a pointer to the end of the compressed sequence (the first byte
+ * AFTER the compressed data).
+ * |previous| is the greatest encoded value in the sequence. The new greatest
+ * value is stored in |*last|.
+ *
+ * As with |vbyte_append_sorted64|, the integers must be strictly increasing
+ * and greater than |previous|.
+ *
+ * This function uses delta encoding.
+ *
+ * Returns the number of bytes written to |end|.
+ */
+extern size_t
+vbyte_append_many_sorted64(uint8_t *end, uint64_t previous,
+                const uint64_t *in, size_t length, uint64_t *last);
+
+/**
+ * Appends |value| to a sequence of compressed 32bit unsigned integers.
+ *
+ * |end| is a pointer to the end of the compressed sequence (the first byte
+ * AFTER the compressed data).
+ *
+ * This function does NOT use encoding.
+ *
+ * Returns the number of bytes required to compress |value|.
+ */
+extern size_t
+vbyte_append_unsorted32(uint8_t *end, uint32_t value);
+
+/**
+ * Appends |value| to a sequence of compressed 64bit unsigned integers.
+ *
+ * |end| is a pointer to the end of the compressed sequence (the first byte
+ * AFTER the compressed data).
+ *
+ * This function does NOT use encoding.
+ *
+ * Returns the number of bytes required to compress |value|.
+ */
+extern size_t
 vbyte_append_unsorted64(uint8_t *end, uint64_t value);
 
+/**
+ * Returns the number of compressed integers in |in|, without decoding them.
+ * Works for 32bit and 64bit integers, with or without delta encoding.
+ *
+ * |size| is the size of the byte array pointed to by |in|.
+ */
+extern size_t
+vbyte_count(const uint8_t *in, size_t size);
+
+/**
+ * Returns the byte offset of the compressed integer at the given |index|,
+ * without decoding the preceding integers. Works for 32bit and 64bit
+ * integers, with or without delta encoding.
+ *
+ * |size| is the size of the byte array pointed to by |in|.
+ * Returns |size| if the sequence has less than |index| + 1 integers.
+ */
+extern size_t
+vbyte_locate(const uint8_t *in, size_t size, size_t index);
+
 
 #ifdef __cplusplus
 } /* extern "C" */